@@ -0,0 +1,57 @@
+import filecmp
+import re
+import shutil
+import subprocess
+import sys
+
+import matplotlib.pyplot as plt
+import pandas as pd
+
+# So sánh thời gian chạy của vanetsdn với kênh Yans gốc và kênh lọc theo phạm vi
+# Chạy trong thư mục python-graph: python3 channel_benchmark.py <thư mục ns-3>
+ns3_dir = sys.argv[1] if len(sys.argv) > 1 else "."
+vehicle_counts = [40, 80, 160, 320]
+result_csv = "simulation_results_sdn_vanet.csv"
+output_file = "Result/channel_benchmark.csv"
+
+wall_pattern = re.compile(r"Thời gian chạy: ([0-9.eE+-]+) s, số sự kiện: (\d+)")
+
+
+def run(vehicles, culled):
+    args = "scratch/vanetsdn --NumVehicles=%d --CulledChannel=%d" % (vehicles, 1 if culled else 0)
+    out = subprocess.run(["./ns3", "run", args], cwd=ns3_dir, capture_output=True, text=True, check=True).stdout
+    match = wall_pattern.search(out)
+    if match is None:
+        raise RuntimeError("Không tìm thấy thời gian chạy trong kết quả của: " + args)
+    # Giữ lại file kết quả để kiểm tra hai chế độ cho cùng kết quả
+    saved = "%s/%s.%d.%s" % (ns3_dir, result_csv, vehicles, "culled" if culled else "full")
+    shutil.copy("%s/%s" % (ns3_dir, result_csv), saved)
+    return float(match.group(1)), int(match.group(2)), saved
+
+
+rows = []
+for n in vehicle_counts:
+    full_wall, full_events, full_csv = run(n, False)
+    culled_wall, culled_events, culled_csv = run(n, True)
+    identical = filecmp.cmp(full_csv, culled_csv, shallow=False)
+    rows.append({'Vehicles': n,
+                 'Full Wall': full_wall, 'Full Events': full_events,
+                 'Culled Wall': culled_wall, 'Culled Events': culled_events,
+                 'Speedup': full_wall / culled_wall if culled_wall > 0 else 0.0,
+                 'Identical': identical})
+    print("%4d xe: gốc %.2f s, lọc %.2f s, kết quả giống nhau: %s" % (n, full_wall, culled_wall, identical))
+
+data = pd.DataFrame(rows)
+data.to_csv(output_file, index=False)
+
+# Vẽ biểu đồ
+plt.figure(figsize=(10, 6))
+plt.plot(data['Vehicles'], data['Full Wall'], marker='o', color='red', label='YansWifiChannel')
+plt.plot(data['Vehicles'], data['Culled Wall'], marker='o', color='green', label='CulledWifiChannel')
+plt.title('Thời gian chạy theo số xe')
+plt.xlabel('Số xe')
+plt.ylabel('Thời gian chạy (s)')
+plt.grid(linestyle='--', alpha=0.7)
+plt.legend()
+plt.tight_layout()
+plt.show()
@@ -1,36 +1,43 @@
 import pandas as pd
 import matplotlib.pyplot as plt
 import numpy as np
+import os
 
 # Đọc dữ liệu từ các file CSV
+# Nếu có kết quả của replicate.py (Result/replicated_<giao thức>.csv) thì vẽ trung bình
+# qua các lần chạy kèm khoảng tin cậy, nếu không thì vẽ một lần chạy duy nhất
 sdn_file = "Result/simulation_results_sdn_vanet.csv"
 aodv_file = "Result/simulation_results_aodv.csv"
 olsr_file = "Result/simulation_results_olsr.csv"
+replicated = {p: "Result/replicated_%s.csv" % p for p in ['sdn', 'aodv', 'olsr']}
+use_replicated = all(os.path.exists(f) for f in replicated.values())
 
-sdn_data = pd.read_csv(sdn_file)
-aodv_data = pd.read_csv(aodv_file)
-olsr_data = pd.read_csv(olsr_file)
 
-# Đảm bảo dữ liệu được sắp xếp theo thời gian
-sdn_data = sdn_data.sort_values(by='Time')
-aodv_data = aodv_data.sort_values(by='Time')
-olsr_data = olsr_data.sort_values(by='Time')
+def load(protocol, single_file):
+    # Trả về thời gian, throughput, delay, PDR và nửa độ rộng khoảng tin cậy (0 nếu chỉ một lần chạy)
+    if use_replicated:
+        data = pd.read_csv(replicated[protocol]).sort_values(by='Time')
+        columns = [data[k + ' Mean'].to_numpy() for k in ['Throughput', 'Avg Delay', 'PDR']]
+        ci = [data[k + ' CI'].to_numpy() for k in ['Throughput', 'Avg Delay', 'PDR']]
+        print("%s: %d lần chạy" % (protocol.upper(), data['Replications'].iloc[0]))
+    else:
+        # Đảm bảo dữ liệu được sắp xếp theo thời gian
+        data = pd.read_csv(single_file).sort_values(by='Time')
+        # Chuyển đổi dữ liệu Series sang mảng numpy để tránh lỗi multi-dimensional indexing
+        columns = [data[k].to_numpy() for k in ['Throughput', 'Avg Delay', 'PDR']]
+        ci = [np.zeros(len(data))] * 3
+    return [data['Time'].to_numpy()] + columns, ci
 
-# Chuyển đổi dữ liệu Series sang mảng numpy để tránh lỗi multi-dimensional indexing
-sdn_time = sdn_data['Time'].to_numpy()
-sdn_throughput = sdn_data['Throughput'].to_numpy()
-sdn_delay = sdn_data['Avg Delay'].to_numpy()
-sdn_pdr = sdn_data['PDR'].to_numpy()
 
-aodv_time = aodv_data['Time'].to_numpy()
-aodv_throughput = aodv_data['Throughput'].to_numpy()
-aodv_delay = aodv_data['Avg Delay'].to_numpy()
-aodv_pdr = aodv_data['PDR'].to_numpy()
+(sdn_time, sdn_throughput, sdn_delay, sdn_pdr), sdn_ci = load('sdn', sdn_file)
+(aodv_time, aodv_throughput, aodv_delay, aodv_pdr), aodv_ci = load('aodv', aodv_file)
+(olsr_time, olsr_throughput, olsr_delay, olsr_pdr), olsr_ci = load('olsr', olsr_file)
 
-olsr_time = olsr_data['Time'].to_numpy()
-olsr_throughput = olsr_data['Throughput'].to_numpy()
-olsr_delay = olsr_data['Avg Delay'].to_numpy()
-olsr_pdr = olsr_data['PDR'].to_numpy()
+
+def band(time, values, ci, color):
+    # Khoảng tin cậy quanh đường trung bình
+    if use_replicated:
+        plt.fill_between(time, values - ci, values + ci, color=color, alpha=0.2)
 
 # Vẽ biểu đồ
 plt.figure(figsize=(15, 15))
@@ -40,6 +47,9 @@ plt.subplot(3, 1, 1)
 plt.plot(sdn_time, sdn_throughput, marker='o', markersize=3, linewidth=2, color='blue', label='SDN')
 plt.plot(aodv_time, aodv_throughput, marker='s', markersize=3, linewidth=2, color='red', label='AODV')
 plt.plot(olsr_time, olsr_throughput, marker='^', markersize=3, linewidth=2, color='green', label='OLSR')
+band(sdn_time, sdn_throughput, sdn_ci[0], 'blue')
+band(aodv_time, aodv_throughput, aodv_ci[0], 'red')
+band(olsr_time, olsr_throughput, olsr_ci[0], 'green')
 
 plt.title('Throughput Comparison', fontsize=14, fontweight='bold')
 plt.xlabel('Time (s)')
@@ -52,6 +62,9 @@ plt.subplot(3, 1, 2)
 plt.plot(sdn_time, sdn_delay, marker='o', markersize=3, linewidth=2, color='blue', label='SDN')
 plt.plot(aodv_time, aodv_delay, marker='s', markersize=3, linewidth=2, color='red', label='AODV')
 plt.plot(olsr_time, olsr_delay, marker='^', markersize=3, linewidth=2, color='green', label='OLSR')
+band(sdn_time, sdn_delay, sdn_ci[1], 'blue')
+band(aodv_time, aodv_delay, aodv_ci[1], 'red')
+band(olsr_time, olsr_delay, olsr_ci[1], 'green')
 
 plt.title('Average Delay Comparison', fontsize=14, fontweight='bold')
 plt.xlabel('Time (s)')
@@ -64,6 +77,9 @@ plt.subplot(3, 1, 3)
 plt.plot(sdn_time, sdn_pdr, marker='o', markersize=3, linewidth=2, color='blue', label='SDN')
 plt.plot(aodv_time, aodv_pdr, marker='s', markersize=3, linewidth=2, color='red', label='AODV')
 plt.plot(olsr_time, olsr_pdr, marker='^', markersize=3, linewidth=2, color='green', label='OLSR')
+band(sdn_time, sdn_pdr, sdn_ci[2], 'blue')
+band(aodv_time, aodv_pdr, aodv_ci[2], 'red')
+band(olsr_time, olsr_pdr, olsr_ci[2], 'green')
 
 plt.title('Packet Delivery Ratio (PDR) Comparison', fontsize=14, fontweight='bold')
 plt.xlabel('Time (s)')
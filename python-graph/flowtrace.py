@@ -0,0 +1,64 @@
+import sys
+
+import numpy as np
+import pandas as pd
+
+# Đọc file chuỗi thời gian theo flow (--FlowTrace, định dạng trong src-code/flowtrace.h)
+# thành DataFrame mà không phân tích văn bản: mỗi khối được đọc thẳng bằng numpy.
+# Dùng: from flowtrace import read_flowtrace; tuples, records = read_flowtrace('flows.vft')
+#       python3 flowtrace.py flows.vft      (in tóm tắt)
+
+HEADER = np.dtype([('magic', 'S4'), ('version', '<u4'), ('tupleSize', '<u4'), ('recordSize', '<u4')])
+CHUNK = np.dtype([('type', '<u4'), ('count', '<u4'), ('time', '<f8')])
+TUPLE = np.dtype([('index', '<u4'), ('flowId', '<u4'), ('source', '<u4'), ('destination', '<u4'),
+                  ('sourcePort', '<u2'), ('destinationPort', '<u2'), ('protocol', 'u1'), ('reserved', 'V3')])
+RECORD = np.dtype([('flowId', '<u4'), ('tupleIndex', '<u4'), ('txPackets', '<u8'), ('rxPackets', '<u8'),
+                   ('txBytes', '<u8'), ('rxBytes', '<u8'), ('lostPackets', '<u8'),
+                   ('delaySum', '<i8'), ('jitterSum', '<i8')])
+TUPLES, RECORDS = 1, 2
+
+
+def format_address(value):
+    return "%d.%d.%d.%d" % ((value >> 24) & 0xff, (value >> 16) & 0xff, (value >> 8) & 0xff, value & 0xff)
+
+
+def read_flowtrace(path):
+    data = np.fromfile(path, dtype=np.uint8)
+    header = np.frombuffer(data[:HEADER.itemsize].tobytes(), dtype=HEADER)[0]
+    if header['magic'] != b'VFT1' or header['tupleSize'] != TUPLE.itemsize \
+            or header['recordSize'] != RECORD.itemsize:
+        raise ValueError(path + " không phải file flow trace phiên bản 1")
+
+    tuple_parts, record_parts, record_times = [], [], []
+    offset = HEADER.itemsize
+    while offset + CHUNK.itemsize <= len(data):
+        chunk = np.frombuffer(data, dtype=CHUNK, count=1, offset=offset)[0]
+        offset += CHUNK.itemsize
+        dtype = TUPLE if chunk['type'] == TUPLES else RECORD
+        entries = np.frombuffer(data, dtype=dtype, count=int(chunk['count']), offset=offset)
+        offset += dtype.itemsize * int(chunk['count'])
+        if chunk['type'] == TUPLES:
+            tuple_parts.append(entries)
+        else:
+            record_parts.append(entries)
+            record_times.append(np.full(len(entries), chunk['time']))
+
+    tuples = pd.DataFrame(np.concatenate(tuple_parts)) if tuple_parts else pd.DataFrame(columns=TUPLE.names)
+    tuples = tuples.drop(columns=['reserved']).set_index('index')
+    tuples['source'] = tuples['source'].map(format_address)
+    tuples['destination'] = tuples['destination'].map(format_address)
+
+    records = pd.DataFrame(np.concatenate(record_parts)) if record_parts else pd.DataFrame(columns=RECORD.names)
+    records.insert(0, 'time', np.concatenate(record_times) if record_times else [])
+    # Thời gian lưu theo ns
+    records['delaySum'] = records['delaySum'] * 1e-9
+    records['jitterSum'] = records['jitterSum'] * 1e-9
+    return tuples, records
+
+
+if __name__ == '__main__':
+    tuples, records = read_flowtrace(sys.argv[1])
+    print("%d flow, %d bản ghi, %d lần lấy mẫu" % (len(tuples), len(records), records['time'].nunique()))
+    last = records.groupby('flowId').last()
+    print(last.join(tuples.set_index('flowId')[['source', 'destination', 'destinationPort']])
+          .sort_values('rxBytes', ascending=False).head(20).to_string())
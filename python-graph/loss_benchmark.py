@@ -0,0 +1,65 @@
+import re
+import subprocess
+import sys
+
+import matplotlib.pyplot as plt
+import pandas as pd
+
+# So sánh thông lượng mô phỏng (sự kiện/giây) của vanetsdn khi tính suy hao trực tiếp
+# và khi tra bảng suy hao, kèm độ lệch KPI cuối cùng giữa hai chế độ
+# Chạy trong thư mục python-graph: python3 loss_benchmark.py <thư mục ns-3>
+ns3_dir = sys.argv[1] if len(sys.argv) > 1 else "."
+vehicle_counts = [40, 80, 160, 320]
+result_csv = "simulation_results_sdn_vanet.csv"
+output_file = "Result/loss_benchmark.csv"
+
+wall_pattern = re.compile(r"Thời gian chạy: ([0-9.eE+-]+) s, số sự kiện: (\d+)")
+error_pattern = re.compile(r"Sai số: lớn nhất ([0-9.eE+-]+) dB")
+
+
+def run(vehicles, cached):
+    # Lần chạy tra bảng in thêm báo cáo sai số để đọc "Sai số: lớn nhất"
+    flag = 1 if cached else 0
+    args = "scratch/vanetsdn --NumVehicles=%d --CachedLoss=%d --LossReport=%d" % (vehicles, flag, flag)
+    out = subprocess.run(["./ns3", "run", args], cwd=ns3_dir, capture_output=True, text=True, check=True).stdout
+    match = wall_pattern.search(out)
+    if match is None:
+        raise RuntimeError("Không tìm thấy thời gian chạy trong kết quả của: " + args)
+    error = error_pattern.search(out)
+    last = pd.read_csv("%s/%s" % (ns3_dir, result_csv)).iloc[-1]
+    wall = float(match.group(1))
+    events = int(match.group(2))
+    return {'wall': wall,
+            'rate': events / wall if wall > 0 else 0.0,
+            'error': float(error.group(1)) if error else 0.0,
+            'throughput': last['Throughput'], 'delay': last['Avg Delay'], 'pdr': last['PDR']}
+
+
+rows = []
+for n in vehicle_counts:
+    exact = run(n, False)
+    cached = run(n, True)
+    rows.append({'Vehicles': n,
+                 'Exact Wall': exact['wall'], 'Exact Events/s': exact['rate'],
+                 'Cached Wall': cached['wall'], 'Cached Events/s': cached['rate'],
+                 'Max Loss Error': cached['error'],
+                 'Throughput Diff': cached['throughput'] - exact['throughput'],
+                 'Delay Diff': cached['delay'] - exact['delay'],
+                 'PDR Diff': cached['pdr'] - exact['pdr']})
+    print("%4d xe: gốc %.0f sự kiện/s, bảng %.0f sự kiện/s, lệch PDR %.3f%%"
+          % (n, exact['rate'], cached['rate'], cached['pdr'] - exact['pdr']))
+
+data = pd.DataFrame(rows)
+data.to_csv(output_file, index=False)
+
+# Vẽ biểu đồ
+plt.figure(figsize=(10, 6))
+plt.plot(data['Vehicles'], data['Exact Events/s'], marker='o', color='red', label='LogDistance')
+plt.plot(data['Vehicles'], data['Cached Events/s'], marker='o', color='green', label='CachedPropagationLossModel')
+plt.title('Thông lượng mô phỏng theo số xe')
+plt.xlabel('Số xe')
+plt.ylabel('Sự kiện/giây')
+plt.grid(linestyle='--', alpha=0.7)
+plt.legend()
+plt.tight_layout()
+plt.show()
@@ -0,0 +1,63 @@
+import re
+import subprocess
+import sys
+
+import matplotlib.pyplot as plt
+import pandas as pd
+
+# So sánh thông lượng mô phỏng (sự kiện/giây) của vanetsdn khi mỗi lần gửi cấp phát
+# một gói tin mới và khi gửi bản sao của gói tin mẫu (PacketReuse), mỗi chế độ chạy
+# với cùng các RngRun
+# Chạy trong thư mục python-graph: python3 packet_benchmark.py <thư mục ns-3>
+ns3_dir = sys.argv[1] if len(sys.argv) > 1 else "."
+runs = [1, 2, 3]
+result_csv = "simulation_results_sdn_vanet.csv"
+output_file = "Result/packet_benchmark.csv"
+
+wall_pattern = re.compile(r"Thời gian chạy: ([0-9.eE+-]+) s, số sự kiện: (\d+)")
+
+
+def run(rng_run, reuse):
+    args = "scratch/vanetsdn --RngRun=%d --PacketReuse=%d" % (rng_run, 1 if reuse else 0)
+    out = subprocess.run(["./ns3", "run", args], cwd=ns3_dir, capture_output=True, text=True, check=True).stdout
+    match = wall_pattern.search(out)
+    if match is None:
+        raise RuntimeError("Không tìm thấy thời gian chạy trong kết quả của: " + args)
+    last = pd.read_csv("%s/%s" % (ns3_dir, result_csv)).iloc[-1]
+    wall = float(match.group(1))
+    events = int(match.group(2))
+    return {'wall': wall,
+            'rate': events / wall if wall > 0 else 0.0,
+            'pdr': last['PDR']}
+
+
+rows = []
+for r in runs:
+    fresh = run(r, False)
+    reuse = run(r, True)
+    rows.append({'Run': r,
+                 'Fresh Wall': fresh['wall'], 'Fresh Events/s': fresh['rate'],
+                 'Reuse Wall': reuse['wall'], 'Reuse Events/s': reuse['rate'],
+                 'Speedup': reuse['rate'] / fresh['rate'] if fresh['rate'] > 0 else 0.0,
+                 'PDR Diff': reuse['pdr'] - fresh['pdr']})
+    print("RngRun %d: cấp phát mới %.0f sự kiện/s, dùng lại %.0f sự kiện/s, lệch PDR %.3f%%"
+          % (r, fresh['rate'], reuse['rate'], reuse['pdr'] - fresh['pdr']))
+
+data = pd.DataFrame(rows)
+data.to_csv(output_file, index=False)
+print("Trung bình: cấp phát mới %.0f sự kiện/s, dùng lại %.0f sự kiện/s (x%.2f)"
+      % (data['Fresh Events/s'].mean(), data['Reuse Events/s'].mean(), data['Speedup'].mean()))
+
+# Vẽ biểu đồ
+plt.figure(figsize=(10, 6))
+width = 0.35
+x = range(len(data))
+plt.bar([i - width / 2 for i in x], data['Fresh Events/s'], width, color='red', label='Create<Packet> mỗi lần gửi')
+plt.bar([i + width / 2 for i in x], data['Reuse Events/s'], width, color='green', label='Bản sao gói tin mẫu')
+plt.xticks(list(x), ['RngRun %d' % r for r in data['Run']])
+plt.title('Thông lượng mô phỏng theo RngRun')
+plt.ylabel('Sự kiện/giây')
+plt.grid(axis='y', linestyle='--', alpha=0.7)
+plt.legend()
+plt.tight_layout()
+plt.show()
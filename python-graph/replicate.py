@@ -0,0 +1,221 @@
+import argparse
+import concurrent.futures
+import math
+import os
+import shutil
+import subprocess
+import sys
+
+import pandas as pd
+
+from sweep import PROGRAMS, parse_list, run_job, run_name
+
+# Lặp lại mô phỏng với RngRun khác nhau cho tới khi khoảng tin cậy của mọi thông số
+# (ở mọi thời điểm lấy mẫu) đủ hẹp. Trung bình và phương sai được cộng dồn theo Welford
+# nên không cần giữ lại toàn bộ dữ liệu các lần chạy.
+# Ví dụ: python3 replicate.py --ns3-dir ~/ns-3-dev --protocols aodv,olsr,sdn --precision 0.05
+# Kết quả: Result/replicated_<giao thức>.csv (Time, <KPI> Mean, <KPI> CI, Replications)
+# Với --warmup T, mỗi lô là một tiến trình: phần khởi động tới T giây chạy một lần rồi
+# fork() một tiến trình con cho mỗi RngRun (tham số WarmupTime/Forks của kịch bản).
+
+KPIS = ['Throughput', 'Avg Delay', 'PDR']
+
+# Phân vị Student t hai phía theo bậc tự do 1..30, lớn hơn thì dùng phân phối chuẩn
+T_TABLE = {
+    0.90: [6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+           1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+           1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697],
+    0.95: [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+           2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+           2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042],
+    0.99: [63.657, 9.925, 5.841, 4.604, 4.032, 3.707, 3.499, 3.355, 3.250, 3.169,
+           3.106, 3.055, 3.012, 2.977, 2.947, 2.921, 2.898, 2.878, 2.861, 2.845,
+           2.831, 2.819, 2.807, 2.797, 2.787, 2.779, 2.771, 2.763, 2.756, 2.750],
+}
+Z_VALUE = {0.90: 1.645, 0.95: 1.960, 0.99: 2.576}
+
+
+def t_quantile(confidence, df):
+    if df <= len(T_TABLE[confidence]):
+        return T_TABLE[confidence][df - 1]
+    return Z_VALUE[confidence]
+
+
+class Welford:
+    """Trung bình và phương sai cộng dồn theo từng phần tử của một mảng."""
+
+    def __init__(self):
+        self.n = 0
+        self.mean = None
+        self.m2 = None
+
+    def add(self, values):
+        self.n += 1
+        if self.mean is None:
+            self.mean = values.astype(float)
+            self.m2 = values * 0.0
+            return
+        delta = values - self.mean
+        self.mean = self.mean + delta / self.n
+        self.m2 = self.m2 + delta * (values - self.mean)
+
+    def half_width(self, confidence):
+        if self.n < 2:
+            return self.mean * 0.0 + math.inf
+        return t_quantile(confidence, self.n - 1) * (self.m2 / (self.n - 1) / self.n) ** 0.5
+
+
+class Replications:
+    """Thông số theo từng thời điểm lấy mẫu của một giao thức qua các lần chạy."""
+
+    def __init__(self, kpis):
+        self.kpis = kpis
+        self.time = None
+        self.stats = {k: Welford() for k in kpis}
+
+    def add(self, data):
+        data = data.sort_values(by='Time').reset_index(drop=True)
+        if self.time is None:
+            self.time = data['Time']
+        # Các lần chạy có cùng lịch lấy mẫu, chỉ xét phần thời gian chung
+        n = min(len(self.time), len(data))
+        self.time = self.time.iloc[:n]
+        for k in self.kpis:
+            stat = self.stats[k]
+            if stat.mean is not None and len(stat.mean) > n:
+                stat.mean = stat.mean.iloc[:n]
+                stat.m2 = stat.m2.iloc[:n]
+            stat.add(data[k].iloc[:n].reset_index(drop=True))
+
+    def count(self):
+        return self.stats[self.kpis[0]].n
+
+    def converged(self, confidence, precision, tolerance):
+        # Nửa độ rộng khoảng tin cậy nhỏ hơn precision * |trung bình| (hoặc tolerance khi trung bình gần 0)
+        for k in self.kpis:
+            stat = self.stats[k]
+            limit = (stat.mean.abs() * precision).clip(lower=tolerance)
+            if (stat.half_width(confidence) > limit).any():
+                return False
+        return True
+
+    def worst(self, confidence):
+        # Tỷ lệ nửa độ rộng / trung bình lớn nhất của từng thông số, để theo dõi tiến độ
+        result = {}
+        for k in self.kpis:
+            stat = self.stats[k]
+            ratio = stat.half_width(confidence) / stat.mean.abs().clip(lower=1e-12)
+            result[k] = ratio.max()
+        return result
+
+    def to_frame(self, confidence):
+        data = pd.DataFrame({'Time': self.time.reset_index(drop=True)})
+        for k in self.kpis:
+            data[k + ' Mean'] = self.stats[k].mean.reset_index(drop=True)
+            data[k + ' CI'] = self.stats[k].half_width(confidence).reset_index(drop=True)
+        data['Replications'] = self.count()
+        return data
+
+
+def run_forked(protocol, first_run, count, args):
+    # Một tiến trình cho cả lô, trả về các file kết quả của tiến trình con theo RngRun
+    run_dir = os.path.join(args.out, "%s_v%d_s%g_r%s_warm%g_run%d-%d" % (
+        protocol, args.vehicles, args.speed, args.rate, args.warmup, first_run, first_run + count - 1))
+    shutil.rmtree(run_dir, ignore_errors=True)
+    os.makedirs(run_dir)
+    program = "%s --NumVehicles=%d --Speed=%g --DataRate=%s --RngRun=%d --OutputFile=%s" % (
+        PROGRAMS[protocol], args.vehicles, args.speed, args.rate, first_run, os.path.join(run_dir, 'results.csv'))
+    program += " --WarmupTime=%g --Forks=%d --ForkJobs=%d --AnimFile=" % (args.warmup, count, args.jobs)
+    if args.extra:
+        program += " " + args.extra
+    with open(os.path.join(run_dir, 'run.log'), 'w') as log:
+        code = subprocess.call(['./ns3', 'run', '--no-build', program], cwd=args.ns3_dir,
+                               stdout=log, stderr=subprocess.STDOUT)
+    if code != 0:
+        print("%s: lỗi (%d), xem %s" % (run_dir, code, os.path.join(run_dir, 'run.log')))
+    results = []
+    for r in range(first_run, first_run + count):
+        path = os.path.join(run_dir, 'results-run%d.csv' % r)
+        if os.path.exists(path):
+            results.append(path)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Replicate the AODV, OLSR and SDN scenarios until the KPI '
+                                                 'confidence intervals are narrow enough')
+    parser.add_argument('--ns3-dir', default='.', help='ns-3 directory containing the scenarios in scratch/')
+    parser.add_argument('--protocols', default='aodv,olsr,sdn')
+    parser.add_argument('--vehicles', type=int, default=40)
+    parser.add_argument('--speed', type=float, default=5.0)
+    parser.add_argument('--rate', default='250Kbps')
+    parser.add_argument('--kpis', default=','.join(KPIS), help='CSV columns that must converge')
+    parser.add_argument('--confidence', type=float, default=0.95, choices=sorted(T_TABLE))
+    parser.add_argument('--precision', type=float, default=0.05,
+                        help='Target CI half-width relative to the mean')
+    parser.add_argument('--tolerance', type=float, default=1e-3,
+                        help='Absolute CI half-width accepted when the mean is close to zero')
+    parser.add_argument('--min-runs', type=int, default=3)
+    parser.add_argument('--max-runs', type=int, default=50)
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='Replications running at once')
+    parser.add_argument('--out', default='replication_runs')
+    parser.add_argument('--result-dir', default='Result')
+    parser.add_argument('--warmup', type=float, default=0.0,
+                        help='Simulate the first WARMUP seconds once per batch and fork the replications')
+    parser.add_argument('--extra', default='', help='Extra arguments passed to every run')
+    parser.add_argument('--no-build', action='store_true', help='Do not build ns-3 before running')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    protocols = parse_list(args.protocols)
+    for p in protocols:
+        if p not in PROGRAMS:
+            sys.exit("Giao thức không hợp lệ: " + p)
+    kpis = parse_list(args.kpis)
+
+    if not args.no_build:
+        subprocess.check_call(['./ns3', 'build'], cwd=args.ns3_dir)
+    os.makedirs(args.out, exist_ok=True)
+    os.makedirs(args.result_dir, exist_ok=True)
+
+    for protocol in protocols:
+        reps = Replications(kpis)
+        next_run = 1
+        # Chạy theo lô --jobs lần, sau mỗi lô kiểm tra khoảng tin cậy
+        while next_run <= args.max_runs:
+            batch = max(1, min(args.jobs, args.max_runs - next_run + 1))
+            if reps.count() + batch < args.min_runs:
+                batch = args.min_runs - reps.count()
+            if args.warmup > 0:
+                for path in run_forked(protocol, next_run, batch, args):
+                    reps.add(pd.read_csv(path))
+            else:
+                jobs = [{'protocol': protocol, 'vehicles': args.vehicles, 'speed': args.speed, 'rate': args.rate,
+                         'run': r} for r in range(next_run, next_run + batch)]
+                with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+                    results = list(pool.map(lambda job: run_job(job, args), jobs))
+                # Cộng dồn theo thứ tự RngRun để kết quả không phụ thuộc thứ tự hoàn thành
+                for job, status in results:
+                    if status.startswith('failed'):
+                        print("%s: %s" % (run_name(job), status))
+                        continue
+                    reps.add(pd.read_csv(os.path.join(args.out, run_name(job), 'results.csv')))
+            next_run += batch
+
+            if reps.count() == 0:
+                sys.exit("Không có lần chạy nào thành công cho " + protocol)
+            worst = reps.worst(args.confidence)
+            print("%s: %d lần chạy, CI/trung bình lớn nhất: %s" % (
+                protocol, reps.count(), ", ".join("%s %.3f" % (k, v) for k, v in worst.items())))
+            if reps.count() >= args.min_runs and reps.converged(args.confidence, args.precision, args.tolerance):
+                break
+        else:
+            print("%s: chưa hội tụ sau %d lần chạy" % (protocol, args.max_runs))
+
+        output_file = os.path.join(args.result_dir, 'replicated_%s.csv' % protocol)
+        reps.to_frame(args.confidence).to_csv(output_file, index=False)
+        print("%s: %d lần chạy, kết quả tại %s" % (protocol, reps.count(), output_file))
+
+
+if __name__ == '__main__':
+    main()
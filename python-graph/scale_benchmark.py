@@ -0,0 +1,119 @@
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import time
+
+import pandas as pd
+
+from sweep import PROGRAMS, parse_list
+
+# Đo khả năng mở rộng của các kịch bản AODV, OLSR và SDN theo số xe.
+# Cạnh vùng mô phỏng tăng theo căn bậc hai số xe để mật độ xe không đổi (40 xe / 500x500m).
+# Ghi lại thời gian chạy, số sự kiện/giây, bộ nhớ đỉnh và thông số cuối cùng vào
+# Result/scale_benchmark.csv và .json để so sánh các lần tối ưu sau với mốc này.
+# Ví dụ: python3 scale_benchmark.py --ns3-dir ~/ns-3-dev --vehicles 40,100,250
+
+BASE_VEHICLES = 40
+BASE_AREA = 500.0
+BASE_RSUS = 2
+
+wall_pattern = re.compile(r"Thời gian chạy: ([0-9.eE+-]+) s, số sự kiện: (\d+)")
+rss_pattern = re.compile(r"Bộ nhớ đỉnh: (\d+) KB")
+setup_pattern = re.compile(r"^Backhaul: .*dựng hạ tầng ([0-9.eE+-]+) s", re.MULTILINE)
+
+
+def scaled(protocol, vehicles):
+    # Giữ mật độ: diện tích tỷ lệ với số xe, số RSU tỷ lệ với diện tích
+    scale = vehicles / BASE_VEHICLES
+    area = BASE_AREA * math.sqrt(scale)
+    rsus = max(1, int(round(BASE_RSUS * scale))) if protocol == 'sdn' else 0
+    return area, rsus
+
+
+def run(protocol, vehicles, args):
+    area, rsus = scaled(protocol, vehicles)
+    run_dir = os.path.join(args.out, "%s_v%d" % (protocol, vehicles))
+    os.makedirs(run_dir, exist_ok=True)
+    result_csv = os.path.join(run_dir, 'results.csv')
+    program = "%s --NumVehicles=%d --AreaSize=%g --OutputFile=%s --AnimFile=" % (
+        PROGRAMS[protocol], vehicles, area, result_csv)
+    if rsus:
+        # RSU phủ lưới trên cả vùng, backhaul là cây switch khi có nhiều RSU
+        program += " --NumRsus=%d --RsuLayout=grid" % rsus
+        program += " --ns3::SdnRoutingStrategy::SwitchFanout=%d" % args.switch_fanout
+    if args.extra:
+        program += " " + args.extra
+
+    row = {'Protocol': protocol, 'Vehicles': vehicles, 'Area': area, 'RSUs': rsus, 'Status': 'ok',
+           'Setup': None, 'Wall': None, 'Events': None, 'Events/s': None, 'Peak RSS (KB)': None,
+           'Throughput': None, 'Avg Delay': None, 'PDR': None}
+    start = time.time()
+    try:
+        out = subprocess.run(['./ns3', 'run', '--no-build', program], cwd=args.ns3_dir, capture_output=True,
+                             text=True, timeout=args.timeout or None).stdout
+    except subprocess.TimeoutExpired:
+        row['Status'] = 'timeout'
+        row['Wall'] = time.time() - start
+        return row
+    with open(os.path.join(run_dir, 'run.log'), 'w') as log:
+        log.write(out)
+
+    match = wall_pattern.search(out)
+    if match is None:
+        row['Status'] = 'failed'
+        return row
+    row['Wall'] = float(match.group(1))
+    row['Events'] = int(match.group(2))
+    row['Events/s'] = row['Events'] / row['Wall'] if row['Wall'] > 0 else 0.0
+    setup = setup_pattern.search(out)
+    if setup:
+        row['Setup'] = float(setup.group(1))
+    rss = rss_pattern.search(out)
+    if rss:
+        row['Peak RSS (KB)'] = int(rss.group(1))
+    last = pd.read_csv(result_csv).iloc[-1]
+    row['Throughput'] = float(last['Throughput'])
+    row['Avg Delay'] = float(last['Avg Delay'])
+    row['PDR'] = float(last['PDR'])
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Scalability benchmark of the AODV, OLSR and SDN scenarios')
+    parser.add_argument('--ns3-dir', default='.', help='ns-3 directory containing the scenarios in scratch/')
+    parser.add_argument('--protocols', default='aodv,olsr,sdn')
+    parser.add_argument('--vehicles', default='40,100,250,500,1000')
+    parser.add_argument('--timeout', type=float, default=0, help='Per-run timeout in seconds (0: none)')
+    parser.add_argument('--out', default='scale_runs')
+    parser.add_argument('--report', default='Result/scale_benchmark')
+    parser.add_argument('--extra', default='', help='Extra arguments passed to every run')
+    parser.add_argument('--switch-fanout', type=int, default=4,
+                        help='SDN: RSUs per edge switch and switches per upper switch (0: one switch)')
+    parser.add_argument('--no-build', action='store_true', help='Do not build ns-3 before the benchmark')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    if not args.no_build:
+        subprocess.check_call(['./ns3', 'build'], cwd=args.ns3_dir)
+
+    # Chạy tuần tự để thời gian đo không bị ảnh hưởng bởi các lần chạy khác
+    rows = []
+    for n in parse_list(args.vehicles, int):
+        for protocol in parse_list(args.protocols):
+            row = run(protocol, n, args)
+            rows.append(row)
+            print("%-4s %5d xe: %s, %s s, %s sự kiện/s, %s KB" % (
+                protocol, n, row['Status'], row['Wall'], row['Events/s'], row['Peak RSS (KB)']))
+
+    os.makedirs(os.path.dirname(args.report) or '.', exist_ok=True)
+    pd.DataFrame(rows).to_csv(args.report + '.csv', index=False)
+    with open(args.report + '.json', 'w') as f:
+        json.dump({'extra': args.extra, 'runs': rows}, f, indent=2)
+    print("Kết quả tại %s.csv và %s.json" % (args.report, args.report))
+
+
+if __name__ == '__main__':
+    main()
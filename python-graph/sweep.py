@@ -0,0 +1,120 @@
+import argparse
+import concurrent.futures
+import itertools
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+import pandas as pd
+
+# Chạy song song lưới tham số (giao thức, số xe, tốc độ, tốc độ dữ liệu, lần chạy RNG)
+# Mỗi lần chạy có thư mục riêng; lần chạy xong có file "done" nên chạy lại lệnh sẽ tiếp tục
+# từ các lần chạy còn thiếu.
+# Ví dụ: python3 sweep.py --ns3-dir ~/ns-3-dev --protocols aodv,olsr,sdn --vehicles 40,100 --runs 5
+
+# Tên chương trình trong scratch của ns-3 cho từng giao thức
+PROGRAMS = {'aodv': 'scratch/aodv', 'olsr': 'scratch/olsr', 'sdn': 'scratch/vanetsdn'}
+
+
+def parse_list(text, cast=str):
+    return [cast(x) for x in text.split(',') if x]
+
+
+def run_name(job):
+    return "%s_v%d_s%g_r%s_run%d" % (job['protocol'], job['vehicles'], job['speed'], job['rate'], job['run'])
+
+
+def run_job(job, args):
+    run_dir = os.path.join(args.out, run_name(job))
+    done_file = os.path.join(run_dir, 'done')
+    if os.path.exists(done_file):
+        return job, 'skipped'
+
+    # Lần chạy dở dang trước đó: xóa và chạy lại từ đầu
+    shutil.rmtree(run_dir, ignore_errors=True)
+    os.makedirs(run_dir)
+    result_csv = os.path.join(run_dir, 'results.csv')
+    program = "%s --NumVehicles=%d --Speed=%g --DataRate=%s --RngRun=%d --OutputFile=%s" % (
+        PROGRAMS[job['protocol']], job['vehicles'], job['speed'], job['rate'], job['run'], result_csv)
+    if args.extra:
+        program += " " + args.extra
+
+    start = time.time()
+    with open(os.path.join(run_dir, 'run.log'), 'w') as log:
+        code = subprocess.call(['./ns3', 'run', '--no-build', program], cwd=args.ns3_dir,
+                               stdout=log, stderr=subprocess.STDOUT)
+    if code != 0:
+        return job, 'failed (%d)' % code
+
+    with open(done_file, 'w') as f:
+        json.dump(dict(job, wall=time.time() - start), f)
+    return job, 'done'
+
+
+def collect(jobs, args):
+    # Gộp dòng cuối của từng file kết quả kèm tham số của lần chạy
+    rows = []
+    for job in jobs:
+        run_dir = os.path.join(args.out, run_name(job))
+        if not os.path.exists(os.path.join(run_dir, 'done')):
+            continue
+        with open(os.path.join(run_dir, 'done')) as f:
+            info = json.load(f)
+        last = pd.read_csv(os.path.join(run_dir, 'results.csv')).iloc[-1]
+        rows.append({'Protocol': job['protocol'], 'Vehicles': job['vehicles'], 'Speed': job['speed'],
+                     'DataRate': job['rate'], 'Run': job['run'], 'Wall': info['wall'],
+                     'Throughput': last['Throughput'], 'Avg Delay': last['Avg Delay'], 'PDR': last['PDR']})
+    data = pd.DataFrame(rows)
+    data.to_csv(os.path.join(args.out, 'summary.csv'), index=False)
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Parameter sweep over the AODV, OLSR and SDN scenarios')
+    parser.add_argument('--ns3-dir', default='.', help='ns-3 directory containing the scenarios in scratch/')
+    parser.add_argument('--protocols', default='aodv,olsr,sdn')
+    parser.add_argument('--vehicles', default='40')
+    parser.add_argument('--speeds', default='5')
+    parser.add_argument('--rates', default='250Kbps')
+    parser.add_argument('--runs', type=int, default=1, help='RNG runs per configuration (RngRun 1..N)')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='Number of simulations running at once')
+    parser.add_argument('--out', default='sweep_results')
+    parser.add_argument('--extra', default='', help='Extra arguments passed to every run')
+    parser.add_argument('--no-build', action='store_true', help='Do not build ns-3 before the sweep')
+    args = parser.parse_args()
+    args.out = os.path.abspath(args.out)
+
+    protocols = parse_list(args.protocols)
+    for p in protocols:
+        if p not in PROGRAMS:
+            sys.exit("Giao thức không hợp lệ: " + p)
+
+    jobs = [{'protocol': p, 'vehicles': v, 'speed': s, 'rate': r, 'run': k}
+            for p, v, s, r, k in itertools.product(protocols, parse_list(args.vehicles, int),
+                                                   parse_list(args.speeds, float), parse_list(args.rates),
+                                                   range(1, args.runs + 1))]
+
+    # Build một lần rồi các lần chạy dùng --no-build để chạy song song được
+    if not args.no_build:
+        subprocess.check_call(['./ns3', 'build'], cwd=args.ns3_dir)
+    os.makedirs(args.out, exist_ok=True)
+
+    print("%d lần chạy, %d tiến trình song song" % (len(jobs), args.jobs))
+    failed = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = [pool.submit(run_job, job, args) for job in jobs]
+        for i, future in enumerate(concurrent.futures.as_completed(futures)):
+            job, status = future.result()
+            failed += status.startswith('failed')
+            print("[%d/%d] %s: %s" % (i + 1, len(jobs), run_name(job), status))
+
+    data = collect(jobs, args)
+    print("Xong %d/%d lần chạy, %d lỗi, tổng hợp tại %s" % (len(data), len(jobs), failed,
+                                                             os.path.join(args.out, 'summary.csv')))
+
+
+if __name__ == '__main__':
+    main()
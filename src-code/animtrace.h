@@ -0,0 +1,351 @@
+#ifndef ANIMTRACE_H
+#define ANIMTRACE_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "resultsink.h"
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+
+// Ghi file NetAnim (định dạng XML netanim-3.108) có giới hạn, thay cho
+// AnimationInterface vốn ghi mọi gói của mọi node trong suốt thời gian mô phỏng:
+//  - chỉ ghi trong cửa sổ [start, stop)
+//  - chỉ theo dõi tối đa MaxNodes node đầu tiên của danh sách Install
+//  - chỉ ghi một phần các lần phát Wi-Fi; lần nhận chỉ được ghi khi lần phát
+//    tương ứng đã được chọn. Không chọn theo Uid vì với PacketReuse các gói của
+//    một ứng dụng có chung Uid, chọn theo Uid sẽ giữ hoặc bỏ cả flow.
+//  - vị trí được lấy mẫu theo chu kỳ riêng, node dịch chuyển chưa tới
+//    ANIM_MIN_MOVE thì không ghi
+// Văn bản được ghi qua ResultSink; tên file kết thúc bằng .gz thì nén trực tiếp
+// bằng tiến trình gzip (giải nén bằng gunzip trước khi mở trong NetAnim).
+class AnimTracer
+{
+public:
+  AnimTracer ();
+
+  void SetWindow (Time start, Time stop);
+  // Tỷ lệ gói được ghi, 0 để chỉ ghi vị trí
+  void SetPacketSampling (double fraction);
+  // 0: không giới hạn
+  void SetMaxNodes (uint32_t maxNodes);
+  void SetPositionInterval (Time interval);
+  void SetArea (double size);
+
+  bool Open (const std::string &path);
+  // Node theo thứ tự ưu tiên khi bị giới hạn số node
+  void Install (const NodeContainer &nodes);
+  void Close (void);
+
+  uint64_t GetPacketCount (void) const;
+  uint64_t GetPositionCount (void) const;
+
+private:
+  void Start (void);
+  void Stop (void);
+  void PollPositions (void);
+  // Chọn lần phát thứ index
+  bool IsSampled (uint64_t index) const;
+  // Bỏ thời điểm phát của các gói đã quá cũ để bảng không lớn dần
+  void PurgeTxTimes (double now);
+
+  static void PhyTxBegin (AnimTracer *tracer, uint32_t nodeId, Ptr<const Packet> packet, double txPowerW);
+  static void PhyRxEnd (AnimTracer *tracer, uint32_t nodeId, Ptr<const Packet> packet);
+
+  ResultSink                             m_sink;
+  Time                                   m_start;
+  Time                                   m_stop;
+  double                                 m_sampling;
+  uint32_t                               m_maxNodes;
+  Time                                   m_positionInterval;
+  double                                 m_area;
+  bool                                   m_active;
+  std::vector<Ptr<Node> >                m_nodes;
+  std::vector<Vector>                    m_lastPositions;  // vị trí đã ghi gần nhất
+  struct Transmission
+  {
+    uint64_t id;       // uId trong file NetAnim: số thứ tự lần phát, không lặp lại
+    double   time;
+  };
+
+  std::unordered_map<uint64_t, Transmission> m_txTimes;    // Uid -> lần phát gần nhất được chọn
+  EventId                                m_pollEvent;
+  uint64_t                               m_packetCount;
+  uint64_t                               m_positionCount;
+  uint64_t                               m_txCount;
+};
+
+const double ANIM_MIN_MOVE = 1.0;        // m
+const double ANIM_TX_TIMEOUT = 1.0;      // s, gói phát lâu hơn thế không còn được nhận
+
+AnimTracer::AnimTracer ()
+  : m_start (Seconds (0)),
+    m_stop (Time::Max ()),
+    m_sampling (1.0),
+    m_maxNodes (0),
+    m_positionInterval (Seconds (1)),
+    m_area (0.0),
+    m_active (false),
+    m_packetCount (0),
+    m_positionCount (0),
+    m_txCount (0)
+{
+}
+
+void
+AnimTracer::SetWindow (Time start, Time stop)
+{
+  m_start = start;
+  m_stop = stop;
+}
+
+void
+AnimTracer::SetPacketSampling (double fraction)
+{
+  m_sampling = fraction;
+}
+
+void
+AnimTracer::SetMaxNodes (uint32_t maxNodes)
+{
+  m_maxNodes = maxNodes;
+}
+
+void
+AnimTracer::SetPositionInterval (Time interval)
+{
+  m_positionInterval = interval;
+}
+
+void
+AnimTracer::SetArea (double size)
+{
+  m_area = size;
+}
+
+bool
+AnimTracer::Open (const std::string &path)
+{
+  std::string::size_type n = path.size ();
+  if (n > 3 && path.compare (n - 3, 3, ".gz") == 0)
+    {
+      // Đường dẫn trong dấu nháy đơn, nháy đơn bên trong viết thành '\''
+      std::string quoted;
+      for (char c : path)
+        {
+          quoted += c == '\'' ? std::string ("'\\''") : std::string (1, c);
+        }
+      if (!m_sink.OpenCommand ("gzip -c > '" + quoted + "'"))
+        {
+          return false;
+        }
+    }
+  else if (!m_sink.Open (path))
+    {
+      return false;
+    }
+  m_sink.Write ("<anim ver=\"netanim-3.108\" filetype=\"animation\" >\n");
+  return true;
+}
+
+void
+AnimTracer::Install (const NodeContainer &nodes)
+{
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      if (m_maxNodes > 0 && m_nodes.size () == m_maxNodes)
+        {
+          break;
+        }
+      Ptr<Node> node = nodes.Get (i);
+      m_nodes.push_back (node);
+      if (m_sampling <= 0)
+        {
+          continue;
+        }
+      for (uint32_t d = 0; d < node->GetNDevices (); d++)
+        {
+          Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice (d));
+          if (!device)
+            {
+              continue;
+            }
+          device->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin",
+                                                         MakeBoundCallback (&AnimTracer::PhyTxBegin, this, node->GetId ()));
+          device->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd",
+                                                         MakeBoundCallback (&AnimTracer::PhyRxEnd, this, node->GetId ()));
+        }
+    }
+  Simulator::Schedule (m_start - Simulator::Now (), &AnimTracer::Start, this);
+}
+
+void
+AnimTracer::Start (void)
+{
+  if (Simulator::Now () >= m_stop)
+    {
+      return;
+    }
+  std::ostringstream out;
+  out << "<topology minX=\"0\" minY=\"0\" maxX=\"" << m_area << "\" maxY=\"" << m_area << "\">\n";
+  m_lastPositions.clear ();
+  for (const Ptr<Node> &node : m_nodes)
+    {
+      Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+      Vector pos = mobility ? mobility->GetPosition () : Vector ();
+      m_lastPositions.push_back (pos);
+      out << "<node id=\"" << node->GetId () << "\" sysId=\"0\" locX=\"" << pos.x
+          << "\" locY=\"" << pos.y << "\" />\n";
+    }
+  out << "</topology>\n";
+  m_sink.Write (out.str ());
+  m_active = true;
+  m_pollEvent = Simulator::Schedule (m_positionInterval, &AnimTracer::PollPositions, this);
+  if (m_stop != Time::Max ())
+    {
+      Simulator::Schedule (m_stop - Simulator::Now (), &AnimTracer::Stop, this);
+    }
+}
+
+void
+AnimTracer::Stop (void)
+{
+  m_active = false;
+  m_pollEvent.Cancel ();
+  m_txTimes.clear ();
+}
+
+void
+AnimTracer::PollPositions (void)
+{
+  double now = Simulator::Now ().GetSeconds ();
+  std::ostringstream out;
+  for (uint32_t i = 0; i < m_nodes.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_nodes[i]->GetObject<MobilityModel> ();
+      if (!mobility)
+        {
+          continue;
+        }
+      Vector pos = mobility->GetPosition ();
+      if (CalculateDistance (pos, m_lastPositions[i]) < ANIM_MIN_MOVE)
+        {
+          continue;
+        }
+      m_lastPositions[i] = pos;
+      m_positionCount++;
+      out << "<nu p=\"p\" t=\"" << now << "\" id=\"" << m_nodes[i]->GetId ()
+          << "\" x=\"" << pos.x << "\" y=\"" << pos.y << "\" />\n";
+    }
+  m_sink.Write (out.str ());
+  PurgeTxTimes (now);
+  m_pollEvent = Simulator::Schedule (m_positionInterval, &AnimTracer::PollPositions, this);
+}
+
+bool
+AnimTracer::IsSampled (uint64_t index) const
+{
+  if (m_sampling >= 1.0)
+    {
+      return true;
+    }
+  // Băm (Fibonacci hashing) về [0, 1): rải đều mà không cần biến ngẫu nhiên,
+  // không làm lệch dãy số của RngRun
+  uint64_t hash = (index + 1) * 0x9E3779B97F4A7C15ULL;
+  return (hash >> 11) * (1.0 / 9007199254740992.0) < m_sampling;
+}
+
+void
+AnimTracer::PurgeTxTimes (double now)
+{
+  for (auto it = m_txTimes.begin (); it != m_txTimes.end ();)
+    {
+      if (now - it->second.time > ANIM_TX_TIMEOUT)
+        {
+          it = m_txTimes.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+void
+AnimTracer::PhyTxBegin (AnimTracer *tracer, uint32_t nodeId, Ptr<const Packet> packet, double /* txPowerW */)
+{
+  if (!tracer->m_active)
+    {
+      return;
+    }
+  uint64_t uid = packet->GetUid ();
+  uint64_t index = tracer->m_txCount++;
+  if (!tracer->IsSampled (index))
+    {
+      // Lần nhận sau đó thuộc lần phát này, không thuộc lần phát cũ cùng Uid
+      tracer->m_txTimes.erase (uid);
+      return;
+    }
+  double now = Simulator::Now ().GetSeconds ();
+  Transmission &tx = tracer->m_txTimes[uid];
+  tx.id = index;
+  tx.time = now;
+  tracer->m_packetCount++;
+  std::ostringstream out;
+  out << "<pr uId=\"" << index << "\" fId=\"" << nodeId << "\" fbTx=\"" << now << "\" />\n";
+  tracer->m_sink.Write (out.str ());
+}
+
+void
+AnimTracer::PhyRxEnd (AnimTracer *tracer, uint32_t nodeId, Ptr<const Packet> packet)
+{
+  if (!tracer->m_active)
+    {
+      return;
+    }
+  // Chỉ ghi lần nhận của gói có lần phát đã được ghi
+  auto it = tracer->m_txTimes.find (packet->GetUid ());
+  if (it == tracer->m_txTimes.end ())
+    {
+      return;
+    }
+  std::ostringstream out;
+  out << "<wpr uId=\"" << it->second.id << "\" tId=\"" << nodeId << "\" fbRx=\"" << it->second.time
+      << "\" lbRx=\"" << Simulator::Now ().GetSeconds () << "\" />\n";
+  tracer->m_sink.Write (out.str ());
+}
+
+void
+AnimTracer::Close (void)
+{
+  if (!m_sink.IsOpen ())
+    {
+      return;
+    }
+  Stop ();
+  m_sink.Write ("</anim>\n");
+  m_sink.Close ();
+}
+
+uint64_t
+AnimTracer::GetPacketCount (void) const
+{
+  return m_packetCount;
+}
+
+uint64_t
+AnimTracer::GetPositionCount (void) const
+{
+  return m_positionCount;
+}
+
+#endif /* ANIMTRACE_H */
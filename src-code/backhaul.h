@@ -0,0 +1,445 @@
+#ifndef BACKHAUL_H
+#define BACKHAUL_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+
+// Sinh backhaul RSU - switch - server theo tham số. Switch tạo thành cây:
+// mỗi switch biên gom Fanout RSU liền số, mỗi tầng trên gom Fanout switch
+// tầng dưới, tới khi còn một switch gốc; server nối vào switch gốc. Fanout 0
+// là một switch duy nhất cho mọi RSU. Với FatTree, băng thông liên kết lên của
+// mỗi cây con nhân theo số RSU bên dưới (fat-tree của Leiserson), liên kết tới
+// server chia đều tổng băng thông RSU.
+// Địa chỉ (mỗi khối /16, cổng switch là thiết bị tầng 2 nên không có địa chỉ):
+//  - 10.1.0.0/16: phần vô tuyến của xe và RSU (do kịch bản cấp)
+//  - 10.2.0.0/16: liên kết lên của RSU, mỗi RSU một /30 theo thứ tự
+//  - 10.3.0.0/16: server, mỗi server một /30
+// RSU liền số nằm chung cây con nên luật của mỗi cổng là vài tiền tố gộp
+// (tách dải /30 liên tiếp thành các khối căn lề) chứ không phải một luật mỗi
+// RSU. Mọi bước đều tuyến tính theo số RSU.
+class BackhaulTopology
+{
+public:
+  struct Route
+  {
+    uint32_t    sw;          // chỉ số switch
+    Ipv4Address network;
+    Ipv4Mask    mask;
+    uint32_t    port;
+  };
+
+  // (chỉ số switch, cổng ra) trên đường từ switch gốc xuống một RSU
+  typedef std::vector<std::pair<uint32_t, uint32_t> > Path;
+
+  BackhaulTopology ();
+
+  void SetFanout (uint32_t fanout);
+  void SetFatTree (bool fatTree);
+  void SetLink (DataRate rate, Time delay);
+  void SetServerCount (uint32_t servers);
+
+  // Tạo switch, server, liên kết p2p và địa chỉ; server được cài internet và
+  // định tuyến tĩnh, RSU có đường tĩnh tới khối server. Switch chưa được cài
+  // OpenFlow.
+  void Build (const NodeContainer &rsus, const std::vector<Vector> &rsuPositions, InternetStackHelper &internet);
+
+  uint32_t GetSwitchCount (void) const;
+  NodeContainer GetSwitches (void) const;
+  // Cổng của switch theo số cổng OpenFlow: phần tử thứ k là cổng k + 1
+  NetDeviceContainer &GetSwitchPorts (uint32_t sw);
+  // Cổng lên switch cha, 0 với switch gốc
+  uint32_t GetUplinkPort (uint32_t sw) const;
+  uint32_t GetRoot (void) const;
+  uint32_t GetDepth (void) const;
+  // Switch biên của RSU
+  uint32_t GetEdgeSwitch (uint32_t rsu) const;
+  // RSU đầu tiên trong dải RSU liền số của cây con
+  uint32_t GetFirstRsu (uint32_t sw) const;
+  const Vector &GetSwitchPosition (uint32_t sw) const;
+  NodeContainer GetServers (void) const;
+  Ipv4Address GetServerAddress (uint32_t server) const;
+  const std::vector<Route> &GetRoutes (void) const;
+  const Path &GetPath (uint32_t rsu) const;
+
+  static Ipv4Address GetVehicleBlock (void);
+  static Ipv4Address GetRsuBlock (void);
+  static Ipv4Address GetServerBlock (void);
+  static Ipv4Mask GetBlockMask (void);
+
+private:
+  struct Switch
+  {
+    int32_t             parent;
+    uint32_t            childIndex;    // cổng childIndex + 1 của switch cha
+    uint32_t            uplink;
+    uint32_t            firstRsu;      // dải RSU liền số của cây con
+    uint32_t            rsuCount;
+    Vector              position;
+    NetDeviceContainer  ports;
+  };
+
+  // Tách dải /30 [first, first + count) của block thành các tiền tố căn lề
+  void AddRangeRoutes (uint32_t sw, Ipv4Address block, uint32_t first, uint32_t count, uint32_t port);
+  DataRate GetRate (uint32_t rsuCount) const;
+
+  uint32_t                  m_fanout;
+  bool                      m_fatTree;
+  DataRate                  m_rate;
+  Time                      m_delay;
+  uint32_t                  m_serverCount;
+  NodeContainer             m_switchNodes;
+  std::vector<Switch>       m_switches;
+  std::vector<uint32_t>     m_edge;          // RSU -> switch biên
+  uint32_t                  m_edgeCount;     // switch biên là 0..m_edgeCount-1
+  uint32_t                  m_depth;
+  NodeContainer             m_servers;
+  std::vector<Ipv4Address>  m_serverAddresses;
+  std::vector<Route>        m_routes;
+  std::vector<Path>         m_paths;
+};
+
+const uint32_t BACKHAUL_MAX_SUBNETS = 16384;   // số /30 trong một khối /16
+
+BackhaulTopology::BackhaulTopology ()
+  : m_fanout (0),
+    m_fatTree (false),
+    m_rate ("100Mbps"),
+    m_delay (MilliSeconds (2)),
+    m_serverCount (1),
+    m_edgeCount (0),
+    m_depth (0)
+{
+}
+
+void
+BackhaulTopology::SetFanout (uint32_t fanout)
+{
+  m_fanout = fanout;
+}
+
+void
+BackhaulTopology::SetFatTree (bool fatTree)
+{
+  m_fatTree = fatTree;
+}
+
+void
+BackhaulTopology::SetLink (DataRate rate, Time delay)
+{
+  m_rate = rate;
+  m_delay = delay;
+}
+
+void
+BackhaulTopology::SetServerCount (uint32_t servers)
+{
+  m_serverCount = servers;
+}
+
+Ipv4Address
+BackhaulTopology::GetVehicleBlock (void)
+{
+  return Ipv4Address ("10.1.0.0");
+}
+
+Ipv4Address
+BackhaulTopology::GetRsuBlock (void)
+{
+  return Ipv4Address ("10.2.0.0");
+}
+
+Ipv4Address
+BackhaulTopology::GetServerBlock (void)
+{
+  return Ipv4Address ("10.3.0.0");
+}
+
+Ipv4Mask
+BackhaulTopology::GetBlockMask (void)
+{
+  return Ipv4Mask ("255.255.0.0");
+}
+
+DataRate
+BackhaulTopology::GetRate (uint32_t rsuCount) const
+{
+  return m_fatTree ? DataRate (m_rate.GetBitRate () * rsuCount) : m_rate;
+}
+
+void
+BackhaulTopology::Build (const NodeContainer &rsus, const std::vector<Vector> &rsuPositions,
+                         InternetStackHelper &internet)
+{
+  uint32_t n = rsus.GetN ();
+  NS_ABORT_MSG_IF (n == 0, "Backhaul needs at least one RSU");
+  NS_ABORT_MSG_IF (n > BACKHAUL_MAX_SUBNETS || m_serverCount > BACKHAUL_MAX_SUBNETS,
+                   "Backhaul supports at most " << BACKHAUL_MAX_SUBNETS << " RSUs and servers");
+  NS_ABORT_MSG_IF (m_serverCount == 0, "Backhaul needs at least one server");
+  NS_ABORT_MSG_IF (m_fanout == 1, "SwitchFanout must be 0 or at least 2");
+  uint32_t fanout = m_fanout == 0 ? n : m_fanout;
+
+  // Tầng biên, rồi gom từng fanout switch của tầng dưới tới khi còn một gốc.
+  // Switch được đánh số theo tầng, gốc là switch cuối cùng.
+  m_edge.resize (n);
+  uint32_t levelBegin = 0;
+  for (uint32_t first = 0; first < n; first += fanout)
+    {
+      Switch sw;
+      sw.parent = -1;
+      sw.childIndex = 0;
+      sw.uplink = 0;
+      sw.firstRsu = first;
+      sw.rsuCount = std::min (fanout, n - first);
+      sw.position = Vector ();
+      for (uint32_t r = first; r < first + sw.rsuCount; r++)
+        {
+          m_edge[r] = m_switches.size ();
+          sw.position.x += rsuPositions[r].x / sw.rsuCount;
+          sw.position.y += rsuPositions[r].y / sw.rsuCount;
+        }
+      m_switches.push_back (sw);
+    }
+  m_edgeCount = m_switches.size ();
+  m_depth = 1;
+  while (m_switches.size () - levelBegin > 1)
+    {
+      uint32_t levelEnd = m_switches.size ();
+      for (uint32_t first = levelBegin; first < levelEnd; first += fanout)
+        {
+          uint32_t last = std::min (first + fanout, levelEnd);
+          Switch sw;
+          sw.parent = -1;
+          sw.childIndex = 0;
+          sw.uplink = 0;
+          sw.firstRsu = m_switches[first].firstRsu;
+          sw.rsuCount = 0;
+          sw.position = Vector ();
+          for (uint32_t c = first; c < last; c++)
+            {
+              m_switches[c].parent = m_switches.size ();
+              m_switches[c].childIndex = c - first;
+              sw.rsuCount += m_switches[c].rsuCount;
+              sw.position.x += m_switches[c].position.x / (last - first);
+              sw.position.y += m_switches[c].position.y / (last - first);
+            }
+          m_switches.push_back (sw);
+        }
+      levelBegin = levelEnd;
+      m_depth++;
+    }
+
+  m_switchNodes.Create (m_switches.size ());
+  m_servers.Create (m_serverCount);
+  internet.Install (m_servers);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (const Switch &sw : m_switches)
+    {
+      positions->Add (sw.position);
+    }
+  const Vector &root = m_switches.back ().position;
+  for (uint32_t i = 0; i < m_serverCount; i++)
+    {
+      positions->Add (Vector (root.x + 20.0 * i, root.y - 50.0, 0.0));
+    }
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (m_switchNodes);
+  mobility.Install (m_servers);
+
+  // Cổng của mỗi switch: các con theo thứ tự, sau đó cổng lên (hoặc server ở
+  // gốc). Tầng dưới được nối trước nên cổng con của switch cha đã đủ khi switch
+  // con thêm cổng lên của nó.
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", TimeValue (m_delay));
+  Ipv4AddressHelper ipv4;
+  Ipv4Mask linkMask ("255.255.255.252");
+  Ipv4StaticRoutingHelper staticHelper;
+  m_paths.assign (n, Path ());
+  for (uint32_t r = 0; r < n; r++)
+    {
+      Switch &edge = m_switches[m_edge[r]];
+      p2p.SetDeviceAttribute ("DataRate", DataRateValue (GetRate (1)));
+      NetDeviceContainer link = p2p.Install (rsus.Get (r), m_switchNodes.Get (m_edge[r]));
+      edge.ports.Add (link.Get (1));
+      ipv4.SetBase (Ipv4Address (GetRsuBlock ().Get () + 4 * r), linkMask);
+      Ipv4InterfaceContainer rsuInterface = ipv4.Assign (NetDeviceContainer (link.Get (0)));
+
+      // RSU gửi thẳng lên backhaul, p2p không cần ARP nên không cần gateway
+      Ptr<Ipv4StaticRouting> rsuRouting = staticHelper.GetStaticRouting (rsus.Get (r)->GetObject<Ipv4> ());
+      rsuRouting->AddNetworkRouteTo (GetServerBlock (), GetBlockMask (), rsuInterface.Get (0).second);
+    }
+  for (uint32_t s = 0; s < m_switches.size (); s++)
+    {
+      Switch &sw = m_switches[s];
+      if (s < m_edgeCount)
+        {
+          // Switch biên: cổng k + 1 tới RSU firstRsu + k
+          for (uint32_t k = 0; k < sw.rsuCount; k++)
+            {
+              AddRangeRoutes (s, GetRsuBlock (), sw.firstRsu + k, 1, k + 1);
+            }
+        }
+      if (sw.parent < 0)
+        {
+          continue;
+        }
+      Switch &parent = m_switches[sw.parent];
+      p2p.SetDeviceAttribute ("DataRate", DataRateValue (GetRate (sw.rsuCount)));
+      NetDeviceContainer link = p2p.Install (m_switchNodes.Get (s), m_switchNodes.Get (sw.parent));
+      sw.ports.Add (link.Get (0));
+      sw.uplink = sw.ports.GetN ();
+      parent.ports.Add (link.Get (1));
+      AddRangeRoutes (sw.parent, GetRsuBlock (), sw.firstRsu, sw.rsuCount, parent.ports.GetN ());
+    }
+
+  uint32_t rootIndex = GetRoot ();
+  Switch &rootSwitch = m_switches[rootIndex];
+  uint32_t perServer = (n + m_serverCount - 1) / m_serverCount;
+  for (uint32_t i = 0; i < m_serverCount; i++)
+    {
+      p2p.SetDeviceAttribute ("DataRate", DataRateValue (GetRate (perServer)));
+      NetDeviceContainer link = p2p.Install (m_servers.Get (i), m_switchNodes.Get (rootIndex));
+      rootSwitch.ports.Add (link.Get (1));
+      Ipv4Address network (GetServerBlock ().Get () + 4 * i);
+      ipv4.SetBase (network, linkMask);
+      Ipv4InterfaceContainer serverInterface = ipv4.Assign (NetDeviceContainer (link.Get (0)));
+      m_serverAddresses.push_back (serverInterface.GetAddress (0));
+      AddRangeRoutes (rootIndex, GetServerBlock (), i, 1, rootSwitch.ports.GetN ());
+
+      // Lưu lượng xuống tới xe: switch chọn RSU theo luật riêng của từng xe
+      uint32_t interface = serverInterface.Get (0).second;
+      Ptr<Ipv4StaticRouting> serverRouting = staticHelper.GetStaticRouting (m_servers.Get (i)->GetObject<Ipv4> ());
+      serverRouting->AddNetworkRouteTo (GetRsuBlock (), GetBlockMask (), interface);
+      serverRouting->AddNetworkRouteTo (GetVehicleBlock (), GetBlockMask (), interface);
+    }
+
+  // Đường từ gốc xuống mỗi RSU: đi ngược từ switch biên
+  for (uint32_t r = 0; r < n; r++)
+    {
+      Path &path = m_paths[r];
+      uint32_t s = m_edge[r];
+      path.push_back (std::make_pair (s, r - m_switches[s].firstRsu + 1));
+      while (m_switches[s].parent >= 0)
+        {
+          path.push_back (std::make_pair (m_switches[s].parent, m_switches[s].childIndex + 1));
+          s = m_switches[s].parent;
+        }
+      std::reverse (path.begin (), path.end ());
+    }
+}
+
+void
+BackhaulTopology::AddRangeRoutes (uint32_t sw, Ipv4Address block, uint32_t first, uint32_t count, uint32_t port)
+{
+  while (count > 0)
+    {
+      // Khối lớn nhất căn lề tại first và không vượt quá count
+      uint32_t size = 1;
+      uint32_t prefix = 30;
+      while (first % (2 * size) == 0 && 2 * size <= count)
+        {
+          size *= 2;
+          prefix--;
+        }
+      Route route;
+      route.sw = sw;
+      route.network = Ipv4Address (block.Get () + 4 * first);
+      route.mask = Ipv4Mask (~((1u << (32 - prefix)) - 1));
+      route.port = port;
+      m_routes.push_back (route);
+      first += size;
+      count -= size;
+    }
+}
+
+uint32_t
+BackhaulTopology::GetSwitchCount (void) const
+{
+  return m_switches.size ();
+}
+
+NodeContainer
+BackhaulTopology::GetSwitches (void) const
+{
+  return m_switchNodes;
+}
+
+NetDeviceContainer &
+BackhaulTopology::GetSwitchPorts (uint32_t sw)
+{
+  return m_switches[sw].ports;
+}
+
+uint32_t
+BackhaulTopology::GetUplinkPort (uint32_t sw) const
+{
+  return m_switches[sw].uplink;
+}
+
+uint32_t
+BackhaulTopology::GetRoot (void) const
+{
+  return m_switches.size () - 1;
+}
+
+uint32_t
+BackhaulTopology::GetDepth (void) const
+{
+  return m_depth;
+}
+
+uint32_t
+BackhaulTopology::GetEdgeSwitch (uint32_t rsu) const
+{
+  return m_edge[rsu];
+}
+
+uint32_t
+BackhaulTopology::GetFirstRsu (uint32_t sw) const
+{
+  return m_switches[sw].firstRsu;
+}
+
+const Vector &
+BackhaulTopology::GetSwitchPosition (uint32_t sw) const
+{
+  return m_switches[sw].position;
+}
+
+NodeContainer
+BackhaulTopology::GetServers (void) const
+{
+  return m_servers;
+}
+
+Ipv4Address
+BackhaulTopology::GetServerAddress (uint32_t server) const
+{
+  return m_serverAddresses[server];
+}
+
+const std::vector<BackhaulTopology::Route> &
+BackhaulTopology::GetRoutes (void) const
+{
+  return m_routes;
+}
+
+const BackhaulTopology::Path &
+BackhaulTopology::GetPath (uint32_t rsu) const
+{
+  return m_paths[rsu];
+}
+
+#endif /* BACKHAUL_H */
@@ -0,0 +1,170 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+
+// Bắt gói Wi-Fi vào bộ đệm vòng trong bộ nhớ, mỗi thiết bị một bộ đệm giới hạn
+// theo số byte; khung cũ nhất bị bỏ khi vượt ngân sách. Chỉ khi Dump được gọi
+// (kịch bản gọi khi thông số vượt ngưỡng) các khung mới được ghi ra pcap, mỗi
+// thiết bị một file <prefix>-<lần dump>-<node>-<device>.pcap như PcapHelper.
+// Khung được giữ dưới dạng Ptr<const Packet> nên chỉ tăng bộ đếm tham chiếu,
+// không sao chép nội dung gói.
+class RingCapture
+{
+public:
+  RingCapture ();
+
+  // Ngân sách byte cho mỗi thiết bị
+  void SetByteBudget (uint32_t bytes);
+  void SetPrefix (const std::string &prefix);
+  void Install (const NetDeviceContainer &devices);
+  bool IsInstalled (void) const;
+
+  // Ghi mọi bộ đệm ra pcap rồi xóa, trả về số file đã ghi
+  uint32_t Dump (void);
+  uint32_t GetDumpCount (void) const;
+
+private:
+  struct Frame
+  {
+    Time              time;
+    Ptr<const Packet> packet;
+  };
+
+  struct Ring
+  {
+    Ptr<NetDevice>    device;
+    std::deque<Frame> frames;
+    uint32_t          bytes;
+  };
+
+  void Push (uint32_t index, Ptr<const Packet> packet);
+
+  static void PhyTxBegin (RingCapture *capture, uint32_t ring, Ptr<const Packet> packet, double txPowerW);
+  static void PhyRxEnd (RingCapture *capture, uint32_t ring, Ptr<const Packet> packet);
+
+  uint32_t           m_budget;
+  std::string        m_prefix;
+  std::vector<Ring>  m_rings;
+  uint32_t           m_dumps;
+};
+
+RingCapture::RingCapture ()
+  : m_budget (0),
+    m_prefix ("capture"),
+    m_dumps (0)
+{
+}
+
+void
+RingCapture::SetByteBudget (uint32_t bytes)
+{
+  m_budget = bytes;
+}
+
+void
+RingCapture::SetPrefix (const std::string &prefix)
+{
+  m_prefix = prefix;
+}
+
+void
+RingCapture::Install (const NetDeviceContainer &devices)
+{
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (i));
+      if (!device)
+        {
+          continue;
+        }
+      uint32_t index = m_rings.size ();
+      Ring ring;
+      ring.device = device;
+      ring.bytes = 0;
+      m_rings.push_back (ring);
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin",
+                                                     MakeBoundCallback (&RingCapture::PhyTxBegin, this, index));
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd",
+                                                     MakeBoundCallback (&RingCapture::PhyRxEnd, this, index));
+    }
+}
+
+bool
+RingCapture::IsInstalled (void) const
+{
+  return !m_rings.empty ();
+}
+
+void
+RingCapture::Push (uint32_t index, Ptr<const Packet> packet)
+{
+  Ring &ring = m_rings[index];
+  Frame frame;
+  frame.time = Simulator::Now ();
+  frame.packet = packet;
+  ring.frames.push_back (frame);
+  ring.bytes += packet->GetSize ();
+  while (ring.bytes > m_budget && !ring.frames.empty ())
+    {
+      ring.bytes -= ring.frames.front ().packet->GetSize ();
+      ring.frames.pop_front ();
+    }
+}
+
+void
+RingCapture::PhyTxBegin (RingCapture *capture, uint32_t ring, Ptr<const Packet> packet, double /* txPowerW */)
+{
+  capture->Push (ring, packet);
+}
+
+void
+RingCapture::PhyRxEnd (RingCapture *capture, uint32_t ring, Ptr<const Packet> packet)
+{
+  capture->Push (ring, packet);
+}
+
+uint32_t
+RingCapture::Dump (void)
+{
+  PcapHelper pcapHelper;
+  uint32_t files = 0;
+  for (Ring &ring : m_rings)
+    {
+      if (ring.frames.empty ())
+        {
+          continue;
+        }
+      std::ostringstream name;
+      name << m_prefix << "-" << m_dumps << "-" << ring.device->GetNode ()->GetId ()
+           << "-" << ring.device->GetIfIndex () << ".pcap";
+      Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (name.str (), std::ios::out, PcapHelper::DLT_IEEE802_11);
+      for (const Frame &frame : ring.frames)
+        {
+          file->Write (frame.time, frame.packet);
+        }
+      ring.frames.clear ();
+      ring.bytes = 0;
+      files++;
+    }
+  m_dumps++;
+  return files;
+}
+
+uint32_t
+RingCapture::GetDumpCount (void) const
+{
+  return m_dumps;
+}
+
+#endif /* CAPTURE_H */
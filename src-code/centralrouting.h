@@ -0,0 +1,788 @@
+#ifndef CENTRALROUTING_H
+#define CENTRALROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "fleet.h"
+#include "spatial.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+
+// Controller logic tính đường cho phần vô tuyến thay cho OLSR. Controller giữ
+// đồ thị kết nối của xe và RSU (có cạnh khi hai node cách nhau không quá
+// LinkRange) và một cây đường đi ngắn nhất (theo số hop) cho mỗi đích: mỗi xe,
+// mỗi RSU, và subnet của server (gốc là mọi RSU). Mỗi chu kỳ controller lấy vị
+// trí xe, so tập láng giềng mới với cũ và chỉ sửa các cây bị ảnh hưởng:
+//  - thêm cạnh: lan truyền khoảng cách giảm từ đầu cạnh được lợi
+//  - mất cạnh thuộc cây: chỉ tính lại cây con phía dưới cạnh đó
+// Next hop đổi ở node nào thì chỉ node đó nhận bản tin cập nhật, cài vào
+// Ipv4StaticRouting sau trễ điều khiển (backhaul + số hop từ RSU gần nhất).
+// Node không còn đường tới RSU nào thì không nhận được bản tin; cập nhật được
+// giữ lại tới khi node nối lại với RSU. Trễ phụ thuộc số hop lúc gửi nên bản
+// tin sau có thể tới trước; mỗi bản tin mang số thứ tự theo node và mục cũ hơn
+// mục đã cài cho cùng đích bị bỏ qua.
+// Với PathMetric=load, khi có nhiều next hop cùng số hop controller chọn node
+// đang chuyển tiếp cho ít đích nhất: lúc tính lại cây con, và mỗi khi cạnh mới
+// hoặc khoảng cách vừa giảm cho node một next hop cùng số hop mà sau khi đổi
+// tải vẫn nhỏ hơn next hop hiện tại.
+class CentralRouteController
+{
+public:
+  enum PathMetric
+  {
+    HOPS,
+    LOAD
+  };
+
+  CentralRouteController ();
+
+  // Node vô tuyến: xe 0..V-1 (vị trí lấy từ fleet) rồi RSU V..V+R-1
+  void Setup (FleetMobility *fleet, const NodeContainer &vehicles, const NodeContainer &rsus,
+              const std::vector<Vector> &rsuPositions, const std::vector<Ipv4Address> &addresses);
+  void SetServerNetwork (Ipv4Address network, Ipv4Mask mask);
+  void SetRange (double meters);
+  void SetInterval (Time interval);
+  void SetPathMetric (PathMetric metric);
+  // Trễ một bản tin điều khiển: backhaul tới RSU rồi perHop cho mỗi hop vô tuyến
+  void SetControlDelay (Time backhaul, Time perHop);
+  // Sau mỗi chu kỳ tính lại mọi cây bằng BFS và dừng nếu khác kết quả gia tăng
+  void SetVerify (bool verify);
+  void Start (void);
+
+  void Report (std::ostream &os) const;
+
+private:
+  struct Entry
+  {
+    uint32_t tree;
+    int32_t  nextHop;   // -1: xóa đường
+  };
+
+  void Update (void);
+  void AddEdge (uint32_t u, uint32_t v);
+  void RemoveEdge (uint32_t u, uint32_t v);
+  // Khoảng cách của start vừa giảm, lan truyền sang láng giềng
+  void Relax (uint32_t tree, uint32_t start);
+  // Cạnh tới parent của child vừa mất, tính lại cây con của child
+  void Repair (uint32_t tree, uint32_t child);
+  void SetParent (uint32_t tree, uint32_t node, int32_t parent);
+  // candidate cùng số hop với parent hiện tại của node; đổi sang nếu tải ít hơn
+  void ConsiderParent (uint32_t tree, uint32_t node, uint32_t candidate);
+  void MarkDirty (uint32_t tree, uint32_t node);
+  void Verify (void) const;
+  // Gửi cập nhật tới các node đang có đường tới RSU
+  void Push (void);
+  void Install (uint32_t node, uint32_t seq, std::vector<Entry> entries, Time detected);
+
+  uint32_t Index (uint32_t tree, uint32_t node) const;
+  uint32_t GetServerTree (void) const;
+
+  FleetMobility              *m_fleet;
+  std::vector<Ptr<Ipv4StaticRouting> > m_routing;
+  std::vector<uint32_t>       m_interfaces;
+  std::vector<Ipv4Address>    m_addresses;
+  std::vector<Vector>         m_rsuPositions;
+  uint32_t                    m_vehicles;
+  uint32_t                    m_nodes;            // số node vô tuyến
+  Ipv4Address                 m_serverNetwork;
+  Ipv4Mask                    m_serverMask;
+  double                      m_range;
+  Time                        m_interval;
+  PathMetric                  m_metric;
+  Time                        m_backhaulDelay;
+  Time                        m_perHopDelay;
+  bool                        m_verify;
+
+  SpatialGrid                 m_grid;
+  std::vector<Vector>         m_positions;
+  std::vector<std::vector<uint32_t> > m_adjacency;  // sắp xếp tăng dần
+  std::vector<uint32_t>       m_dist;             // [tree * nodes + node]
+  std::vector<int32_t>        m_parent;
+  std::vector<int32_t>        m_installed;        // next hop đã gửi xuống node
+  std::vector<uint32_t>       m_sentSeq;          // số thứ tự bản tin cuối đã gửi, theo node
+  std::vector<uint32_t>       m_appliedSeq;       // bản tin đã cài mục của (cây, node)
+  // Chỉ số mục trong Ipv4StaticRouting theo (đích, mask), mỗi node một bảng
+  std::vector<std::map<std::pair<uint32_t, uint32_t>, uint32_t> > m_routeIndex;
+  std::vector<uint32_t>       m_load;             // số (cây, node) dùng node làm next hop
+  std::vector<char>           m_dirty;
+  std::vector<std::vector<uint32_t> > m_pending;  // cây có next hop đổi, theo node
+  std::vector<Time>           m_pendingSince;
+  std::vector<char>           m_inSubtree;
+
+  uint64_t                    m_linkUps;
+  uint64_t                    m_linkDowns;
+  uint64_t                    m_repairs;          // số node được tính lại khi mất cạnh
+  uint64_t                    m_routeUpdates;     // số mục định tuyến đã cài
+  uint64_t                    m_messages;
+  uint64_t                    m_installs;         // bản tin đã tới node
+  uint64_t                    m_staleEntries;     // mục tới sau mục mới hơn, bị bỏ qua
+  uint64_t                    m_controlBytes;     // bản tin cập nhật, tính trên từng hop vô tuyến
+  uint64_t                    m_reportBytes;      // báo cáo vị trí của xe
+  double                      m_latencySum;
+  double                      m_latencyMax;
+};
+
+const uint32_t CENTRAL_UNREACHABLE = UINT32_MAX;
+// Kích thước bản tin điều khiển (byte): IP + UDP, đầu bản tin, mỗi mục
+// (đích, độ dài tiền tố, next hop), báo cáo vị trí và vận tốc của xe
+const uint32_t CENTRAL_IP_UDP_BYTES = 28;
+const uint32_t CENTRAL_HEADER_BYTES = 8;
+const uint32_t CENTRAL_ENTRY_BYTES = 9;
+const uint32_t CENTRAL_REPORT_BYTES = 16;
+
+CentralRouteController::CentralRouteController ()
+  : m_fleet (0),
+    m_vehicles (0),
+    m_nodes (0),
+    m_range (0.0),
+    m_interval (MilliSeconds (500)),
+    m_metric (HOPS),
+    m_backhaulDelay (MilliSeconds (2)),
+    m_perHopDelay (MilliSeconds (5)),
+    m_verify (false),
+    m_linkUps (0),
+    m_linkDowns (0),
+    m_repairs (0),
+    m_routeUpdates (0),
+    m_messages (0),
+    m_installs (0),
+    m_staleEntries (0),
+    m_controlBytes (0),
+    m_reportBytes (0),
+    m_latencySum (0.0),
+    m_latencyMax (0.0)
+{
+}
+
+void
+CentralRouteController::Setup (FleetMobility *fleet, const NodeContainer &vehicles, const NodeContainer &rsus,
+                               const std::vector<Vector> &rsuPositions, const std::vector<Ipv4Address> &addresses)
+{
+  m_fleet = fleet;
+  m_vehicles = vehicles.GetN ();
+  m_nodes = vehicles.GetN () + rsus.GetN ();
+  m_rsuPositions = rsuPositions;
+  m_addresses = addresses;
+  Ipv4StaticRoutingHelper staticHelper;
+  for (uint32_t n = 0; n < m_nodes; n++)
+    {
+      Ptr<Node> node = n < m_vehicles ? vehicles.Get (n) : rsus.Get (n - m_vehicles);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      m_routing.push_back (staticHelper.GetStaticRouting (ipv4));
+      m_interfaces.push_back (ipv4->GetInterfaceForAddress (addresses[n]));
+    }
+  // Các mục có sẵn trong bảng; mục thêm sau đó luôn nằm ở cuối bảng
+  m_routeIndex.assign (m_nodes, std::map<std::pair<uint32_t, uint32_t>, uint32_t> ());
+  for (uint32_t n = 0; n < m_nodes; n++)
+    {
+      for (uint32_t i = 0; i < m_routing[n]->GetNRoutes (); i++)
+        {
+          Ipv4RoutingTableEntry route = m_routing[n]->GetRoute (i);
+          m_routeIndex[n][std::make_pair (route.GetDest ().Get (), route.GetDestNetworkMask ().Get ())] = i;
+        }
+    }
+
+  uint32_t trees = m_nodes + 1;
+  m_adjacency.assign (m_nodes, std::vector<uint32_t> ());
+  m_dist.assign (trees * m_nodes, CENTRAL_UNREACHABLE);
+  m_parent.assign (trees * m_nodes, -1);
+  m_installed.assign (trees * m_nodes, -1);
+  m_sentSeq.assign (m_nodes, 0);
+  m_appliedSeq.assign (trees * m_nodes, 0);
+  m_dirty.assign (trees * m_nodes, 0);
+  m_load.assign (m_nodes, 0);
+  m_pending.assign (m_nodes, std::vector<uint32_t> ());
+  m_pendingSince.assign (m_nodes, Seconds (0));
+  m_inSubtree.assign (m_nodes, 0);
+  // Gốc của cây đích t là chính node t; cây server có gốc là mọi RSU
+  for (uint32_t n = 0; n < m_nodes; n++)
+    {
+      m_dist[Index (n, n)] = 0;
+    }
+  for (uint32_t r = m_vehicles; r < m_nodes; r++)
+    {
+      m_dist[Index (GetServerTree (), r)] = 0;
+    }
+}
+
+void
+CentralRouteController::SetServerNetwork (Ipv4Address network, Ipv4Mask mask)
+{
+  m_serverNetwork = network;
+  m_serverMask = mask;
+}
+
+void
+CentralRouteController::SetRange (double meters)
+{
+  m_range = meters;
+  m_grid.SetCellSize (meters);
+}
+
+void
+CentralRouteController::SetInterval (Time interval)
+{
+  m_interval = interval;
+}
+
+void
+CentralRouteController::SetPathMetric (PathMetric metric)
+{
+  m_metric = metric;
+}
+
+void
+CentralRouteController::SetControlDelay (Time backhaul, Time perHop)
+{
+  m_backhaulDelay = backhaul;
+  m_perHopDelay = perHop;
+}
+
+void
+CentralRouteController::SetVerify (bool verify)
+{
+  m_verify = verify;
+}
+
+void
+CentralRouteController::Start (void)
+{
+  m_grid.Clear ();
+  for (uint32_t r = 0; r < m_rsuPositions.size (); r++)
+    {
+      m_grid.Insert (m_vehicles + r, m_rsuPositions[r]);
+    }
+  // RSU đứng yên nên cạnh giữa hai RSU chỉ cần thêm một lần
+  for (uint32_t a = 0; a < m_rsuPositions.size (); a++)
+    {
+      for (uint32_t b = a + 1; b < m_rsuPositions.size (); b++)
+        {
+          if (CalculateDistance (m_rsuPositions[a], m_rsuPositions[b]) <= m_range)
+            {
+              AddEdge (m_vehicles + a, m_vehicles + b);
+            }
+        }
+    }
+  Simulator::ScheduleNow (&CentralRouteController::Update, this);
+}
+
+uint32_t
+CentralRouteController::Index (uint32_t tree, uint32_t node) const
+{
+  return tree * m_nodes + node;
+}
+
+uint32_t
+CentralRouteController::GetServerTree (void) const
+{
+  return m_nodes;
+}
+
+void
+CentralRouteController::Update (void)
+{
+  m_fleet->GetPositions (m_positions);
+  for (uint32_t i = 0; i < m_vehicles; i++)
+    {
+      if (m_grid.Contains (i))
+        {
+          m_grid.Update (i, m_positions[i]);
+        }
+      else
+        {
+          m_grid.Insert (i, m_positions[i]);
+        }
+    }
+
+  // Chỉ xét cạnh (u, v) với u < v, mỗi cạnh một lần; RSU có chỉ số lớn hơn
+  // mọi xe nên cạnh xe - RSU được xét ở lượt của xe
+  std::vector<uint32_t> neighbors;
+  std::vector<std::pair<uint32_t, uint32_t> > added;
+  std::vector<std::pair<uint32_t, uint32_t> > removed;
+  for (uint32_t u = 0; u < m_vehicles; u++)
+    {
+      m_grid.QueryRadius (m_positions[u], m_range, neighbors);
+      const std::vector<uint32_t> &old = m_adjacency[u];
+      std::vector<uint32_t>::const_iterator a = neighbors.begin ();
+      std::vector<uint32_t>::const_iterator b = old.begin ();
+      while (a != neighbors.end () || b != old.end ())
+        {
+          if (b == old.end () || (a != neighbors.end () && *a < *b))
+            {
+              if (*a > u)
+                {
+                  added.push_back (std::make_pair (u, *a));
+                }
+              ++a;
+            }
+          else if (a == neighbors.end () || *b < *a)
+            {
+              // Cạnh tới xe có chỉ số nhỏ hơn đã được xét ở lượt của xe đó
+              if (*b > u)
+                {
+                  removed.push_back (std::make_pair (u, *b));
+                }
+              ++b;
+            }
+          else
+            {
+              ++a;
+              ++b;
+            }
+        }
+    }
+
+  // Xóa trước để cây con không tạm nối qua cạnh đã mất
+  for (const auto &edge : removed)
+    {
+      RemoveEdge (edge.first, edge.second);
+    }
+  for (const auto &edge : added)
+    {
+      AddEdge (edge.first, edge.second);
+    }
+  if (m_verify)
+    {
+      Verify ();
+    }
+
+  // Xe có đường tới RSU gửi báo cáo vị trí mỗi chu kỳ
+  uint32_t serverTree = GetServerTree ();
+  for (uint32_t i = 0; i < m_vehicles; i++)
+    {
+      uint32_t hops = m_dist[Index (serverTree, i)];
+      if (hops != CENTRAL_UNREACHABLE)
+        {
+          m_reportBytes += uint64_t (CENTRAL_IP_UDP_BYTES + CENTRAL_REPORT_BYTES) * hops;
+        }
+    }
+  Push ();
+  Simulator::Schedule (m_interval, &CentralRouteController::Update, this);
+}
+
+void
+CentralRouteController::AddEdge (uint32_t u, uint32_t v)
+{
+  m_linkUps++;
+  std::vector<uint32_t> &adjU = m_adjacency[u];
+  std::vector<uint32_t> &adjV = m_adjacency[v];
+  adjU.insert (std::lower_bound (adjU.begin (), adjU.end (), v), v);
+  adjV.insert (std::lower_bound (adjV.begin (), adjV.end (), u), u);
+  for (uint32_t tree = 0; tree <= m_nodes; tree++)
+    {
+      uint32_t du = m_dist[Index (tree, u)];
+      uint32_t dv = m_dist[Index (tree, v)];
+      // Bằng nhau thì chỉ đổi next hop khi PathMetric=load và tải giảm
+      if (du != CENTRAL_UNREACHABLE && du + 1 < dv)
+        {
+          m_dist[Index (tree, v)] = du + 1;
+          SetParent (tree, v, u);
+          Relax (tree, v);
+        }
+      else if (dv != CENTRAL_UNREACHABLE && dv + 1 < du)
+        {
+          m_dist[Index (tree, u)] = dv + 1;
+          SetParent (tree, u, v);
+          Relax (tree, u);
+        }
+      else if (du != CENTRAL_UNREACHABLE && du + 1 == dv)
+        {
+          ConsiderParent (tree, v, u);
+        }
+      else if (dv != CENTRAL_UNREACHABLE && dv + 1 == du)
+        {
+          ConsiderParent (tree, u, v);
+        }
+    }
+}
+
+void
+CentralRouteController::RemoveEdge (uint32_t u, uint32_t v)
+{
+  m_linkDowns++;
+  std::vector<uint32_t> &adjU = m_adjacency[u];
+  std::vector<uint32_t> &adjV = m_adjacency[v];
+  adjU.erase (std::lower_bound (adjU.begin (), adjU.end (), v));
+  adjV.erase (std::lower_bound (adjV.begin (), adjV.end (), u));
+  for (uint32_t tree = 0; tree <= m_nodes; tree++)
+    {
+      // Cạnh không thuộc cây thì mọi khoảng cách của cây vẫn đúng
+      if (m_parent[Index (tree, v)] == int32_t (u))
+        {
+          Repair (tree, v);
+        }
+      else if (m_parent[Index (tree, u)] == int32_t (v))
+        {
+          Repair (tree, u);
+        }
+    }
+}
+
+void
+CentralRouteController::Relax (uint32_t tree, uint32_t start)
+{
+  std::queue<uint32_t> queue;
+  queue.push (start);
+  while (!queue.empty ())
+    {
+      uint32_t x = queue.front ();
+      queue.pop ();
+      uint32_t dx = m_dist[Index (tree, x)];
+      for (uint32_t w : m_adjacency[x])
+        {
+          if (dx + 1 < m_dist[Index (tree, w)])
+            {
+              m_dist[Index (tree, w)] = dx + 1;
+              SetParent (tree, w, x);
+              queue.push (w);
+            }
+          else if (dx + 1 == m_dist[Index (tree, w)])
+            {
+              // Khoảng cách của w không đổi nên không cần lan truyền tiếp
+              ConsiderParent (tree, w, x);
+            }
+        }
+    }
+}
+
+void
+CentralRouteController::Repair (uint32_t tree, uint32_t child)
+{
+  // Cây con của child: con của một node luôn là láng giềng của nó
+  std::vector<uint32_t> subtree (1, child);
+  m_inSubtree[child] = 1;
+  for (uint32_t i = 0; i < subtree.size (); i++)
+    {
+      uint32_t x = subtree[i];
+      for (uint32_t w : m_adjacency[x])
+        {
+          if (!m_inSubtree[w] && m_parent[Index (tree, w)] == int32_t (x))
+            {
+              m_inSubtree[w] = 1;
+              subtree.push_back (w);
+            }
+        }
+    }
+  m_repairs += subtree.size ();
+
+  // Khoảng cách tạm của mỗi node là qua láng giềng tốt nhất ngoài cây con,
+  // rồi Dijkstra bên trong cây con
+  typedef std::pair<uint32_t, uint32_t> QueueItem;
+  std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+  std::vector<int32_t> parents (subtree.size (), -1);
+  for (uint32_t i = 0; i < subtree.size (); i++)
+    {
+      uint32_t x = subtree[i];
+      uint32_t best = CENTRAL_UNREACHABLE;
+      int32_t bestParent = -1;
+      for (uint32_t w : m_adjacency[x])
+        {
+          uint32_t dw = m_dist[Index (tree, w)];
+          if (m_inSubtree[w] || dw == CENTRAL_UNREACHABLE)
+            {
+              continue;
+            }
+          bool better = dw + 1 < best;
+          if (!better && dw + 1 == best && m_metric == LOAD)
+            {
+              better = m_load[w] < m_load[bestParent];
+            }
+          if (better)
+            {
+              best = dw + 1;
+              bestParent = w;
+            }
+        }
+      m_dist[Index (tree, x)] = best;
+      parents[i] = bestParent;
+      if (best != CENTRAL_UNREACHABLE)
+        {
+          queue.push (QueueItem (best, x));
+        }
+    }
+  for (uint32_t i = 0; i < subtree.size (); i++)
+    {
+      SetParent (tree, subtree[i], parents[i]);
+    }
+  while (!queue.empty ())
+    {
+      QueueItem item = queue.top ();
+      queue.pop ();
+      uint32_t x = item.second;
+      if (item.first != m_dist[Index (tree, x)])
+        {
+          continue;
+        }
+      for (uint32_t w : m_adjacency[x])
+        {
+          if (m_inSubtree[w] && item.first + 1 < m_dist[Index (tree, w)])
+            {
+              m_dist[Index (tree, w)] = item.first + 1;
+              SetParent (tree, w, x);
+              queue.push (QueueItem (item.first + 1, w));
+            }
+          else if (m_inSubtree[w] && item.first + 1 == m_dist[Index (tree, w)])
+            {
+              ConsiderParent (tree, w, x);
+            }
+        }
+    }
+  for (uint32_t x : subtree)
+    {
+      m_inSubtree[x] = 0;
+    }
+}
+
+void
+CentralRouteController::SetParent (uint32_t tree, uint32_t node, int32_t parent)
+{
+  int32_t &current = m_parent[Index (tree, node)];
+  if (current == parent)
+    {
+      return;
+    }
+  if (current >= 0)
+    {
+      m_load[current]--;
+    }
+  if (parent >= 0)
+    {
+      m_load[parent]++;
+    }
+  current = parent;
+  MarkDirty (tree, node);
+}
+
+void
+CentralRouteController::ConsiderParent (uint32_t tree, uint32_t node, uint32_t candidate)
+{
+  if (m_metric != LOAD)
+    {
+      return;
+    }
+  int32_t current = m_parent[Index (tree, node)];
+  // Sau khi đổi, candidate nhận thêm 1 và current bớt 1: chỉ đổi khi tải lớn
+  // nhất của hai node giảm, nếu không hai node sẽ đổi qua đổi lại
+  if (current >= 0 && current != int32_t (candidate) && m_load[candidate] + 1 < m_load[current])
+    {
+      SetParent (tree, node, candidate);
+    }
+}
+
+void
+CentralRouteController::MarkDirty (uint32_t tree, uint32_t node)
+{
+  char &dirty = m_dirty[Index (tree, node)];
+  if (dirty)
+    {
+      return;
+    }
+  dirty = 1;
+  if (m_pending[node].empty ())
+    {
+      m_pendingSince[node] = Simulator::Now ();
+    }
+  m_pending[node].push_back (tree);
+}
+
+void
+CentralRouteController::Verify (void) const
+{
+  // Khoảng cách phải bằng BFS; parent có thể khác BFS khi nhiều next hop cùng
+  // số hop, nhưng phải là láng giềng gần gốc hơn đúng một hop
+  std::vector<uint32_t> dist (m_nodes);
+  std::vector<uint32_t> load (m_nodes, 0);
+  std::queue<uint32_t> queue;
+  for (uint32_t tree = 0; tree <= m_nodes; tree++)
+    {
+      std::fill (dist.begin (), dist.end (), CENTRAL_UNREACHABLE);
+      for (uint32_t n = 0; n < m_nodes; n++)
+        {
+          bool root = tree == GetServerTree () ? n >= m_vehicles : n == tree;
+          if (root)
+            {
+              dist[n] = 0;
+              queue.push (n);
+            }
+        }
+      while (!queue.empty ())
+        {
+          uint32_t x = queue.front ();
+          queue.pop ();
+          for (uint32_t w : m_adjacency[x])
+            {
+              if (dist[w] == CENTRAL_UNREACHABLE)
+                {
+                  dist[w] = dist[x] + 1;
+                  queue.push (w);
+                }
+            }
+        }
+      for (uint32_t n = 0; n < m_nodes; n++)
+        {
+          uint32_t index = Index (tree, n);
+          NS_ABORT_MSG_UNLESS (m_dist[index] == dist[n], "Central routing: tree " << tree << " node " << n
+                               << " distance " << m_dist[index] << ", BFS " << dist[n]);
+          int32_t parent = m_parent[index];
+          if (dist[n] == 0 || dist[n] == CENTRAL_UNREACHABLE)
+            {
+              NS_ABORT_MSG_UNLESS (parent < 0, "Central routing: tree " << tree << " node " << n
+                                   << " has parent " << parent << " without a path");
+              continue;
+            }
+          NS_ABORT_MSG_UNLESS (parent >= 0 && dist[parent] + 1 == dist[n]
+                               && std::binary_search (m_adjacency[n].begin (), m_adjacency[n].end (),
+                                                      uint32_t (parent)),
+                               "Central routing: tree " << tree << " node " << n << " has invalid parent " << parent);
+          load[parent]++;
+        }
+    }
+  NS_ABORT_MSG_UNLESS (load == m_load, "Central routing: forwarding load out of sync with the trees");
+}
+
+void
+CentralRouteController::Push (void)
+{
+  uint32_t serverTree = GetServerTree ();
+  for (uint32_t n = 0; n < m_nodes; n++)
+    {
+      if (m_pending[n].empty ())
+        {
+          continue;
+        }
+      uint32_t hops = m_dist[Index (serverTree, n)];
+      if (hops == CENTRAL_UNREACHABLE)
+        {
+          continue;
+        }
+      // Next hop có thể đã quay lại giá trị đã cài, chỉ gửi mục thật sự đổi
+      std::vector<Entry> entries;
+      for (uint32_t tree : m_pending[n])
+        {
+          uint32_t index = Index (tree, n);
+          m_dirty[index] = 0;
+          if (m_parent[index] != m_installed[index])
+            {
+              Entry entry;
+              entry.tree = tree;
+              entry.nextHop = m_parent[index];
+              entries.push_back (entry);
+              m_installed[index] = m_parent[index];
+            }
+        }
+      m_pending[n].clear ();
+      if (entries.empty ())
+        {
+          continue;
+        }
+      uint32_t bytes = CENTRAL_IP_UDP_BYTES + CENTRAL_HEADER_BYTES + CENTRAL_ENTRY_BYTES * entries.size ();
+      m_controlBytes += uint64_t (bytes) * hops;
+      m_messages++;
+      Time delay = m_backhaulDelay + NanoSeconds (m_perHopDelay.GetNanoSeconds () * hops);
+      Simulator::Schedule (delay, &CentralRouteController::Install, this, n, ++m_sentSeq[n], entries,
+                           m_pendingSince[n]);
+    }
+}
+
+void
+CentralRouteController::Install (uint32_t node, uint32_t seq, std::vector<Entry> entries, Time detected)
+{
+  Ptr<Ipv4StaticRouting> routing = m_routing[node];
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> &routeIndex = m_routeIndex[node];
+  Ipv4Mask hostMask = Ipv4Mask::GetOnes ();
+  uint32_t applied = 0;
+  for (const Entry &entry : entries)
+    {
+      // Bản tin gửi sau đã cài đường cho đích này
+      uint32_t &appliedSeq = m_appliedSeq[Index (entry.tree, node)];
+      if (seq < appliedSeq)
+        {
+          m_staleEntries++;
+          continue;
+        }
+      appliedSeq = seq;
+      applied++;
+
+      bool server = entry.tree == GetServerTree ();
+      Ipv4Address dest = server ? m_serverNetwork : m_addresses[entry.tree];
+      Ipv4Mask mask = server ? m_serverMask : hostMask;
+      std::pair<uint32_t, uint32_t> key (dest.Get (), mask.Get ());
+      std::map<std::pair<uint32_t, uint32_t>, uint32_t>::iterator it = routeIndex.find (key);
+      if (it != routeIndex.end ())
+        {
+          // Các mục phía sau lùi lên một chỗ
+          uint32_t removed = it->second;
+          routing->RemoveRoute (removed);
+          routeIndex.erase (it);
+          for (std::pair<const std::pair<uint32_t, uint32_t>, uint32_t> &other : routeIndex)
+            {
+              if (other.second > removed)
+                {
+                  other.second--;
+                }
+            }
+        }
+      if (entry.nextHop < 0)
+        {
+          continue;
+        }
+      Ipv4Address gateway = m_addresses[entry.nextHop];
+      if (server)
+        {
+          routing->AddNetworkRouteTo (dest, mask, gateway, m_interfaces[node]);
+        }
+      else if (uint32_t (entry.nextHop) == entry.tree)
+        {
+          routing->AddHostRouteTo (dest, m_interfaces[node]);
+        }
+      else
+        {
+          routing->AddHostRouteTo (dest, gateway, m_interfaces[node]);
+        }
+      routeIndex[key] = routing->GetNRoutes () - 1;
+    }
+  if (applied == 0)
+    {
+      return;
+    }
+  m_routeUpdates += applied;
+  m_installs++;
+  double latency = (Simulator::Now () - detected).GetSeconds ();
+  m_latencySum += latency;
+  m_latencyMax = std::max (m_latencyMax, latency);
+}
+
+void
+CentralRouteController::Report (std::ostream &os) const
+{
+  double seconds = Simulator::Now ().GetSeconds ();
+  os << "Định tuyến tập trung: " << m_linkUps << " cạnh mới, " << m_linkDowns << " cạnh mất, "
+     << m_repairs << " node tính lại, " << m_routeUpdates << " mục định tuyến trong "
+     << m_messages << " bản tin, " << m_staleEntries << " mục tới muộn bị bỏ qua" << std::endl;
+  if (m_installs > 0)
+    {
+      os << "  Trễ cập nhật đường: trung bình " << m_latencySum / m_installs * 1000.0
+         << " ms, tối đa " << m_latencyMax * 1000.0 << " ms (từ lúc phát hiện, chu kỳ "
+         << m_interval.GetSeconds () * 1000.0 << " ms)" << std::endl;
+    }
+  os << "  Byte điều khiển vô tuyến: " << m_controlBytes << " cập nhật + " << m_reportBytes
+     << " báo cáo vị trí";
+  if (seconds > 0)
+    {
+      os << " (" << (m_controlBytes + m_reportBytes) * 8.0 / seconds / 1000.0 << " kbit/s)";
+    }
+  os << std::endl;
+}
+
+#endif /* CENTRALROUTING_H */
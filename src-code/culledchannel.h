@@ -0,0 +1,405 @@
+#ifndef CULLEDCHANNEL_H
+#define CULLEDCHANNEL_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/wifi-module.h"
+#include "spatial.h"
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+
+// Kênh Yans chỉ lập lịch nhận cho các PHY nằm trong phạm vi có thể giải mã.
+// Phạm vi được tính một lần từ mô hình suy hao (giả thiết suy hao tất định và
+// tăng theo khoảng cách, như LogDistance/ThreeLogDistance) với ngưỡng thấp hơn
+// mọi ngưỡng nhận có thể có, nên mọi khung tin bị bỏ qua đều là khung mà
+// YansWifiChannel::Receive sẽ loại vì quá yếu. Các PHY còn lại được lập lịch
+// theo đúng thứ tự của kênh gốc nên khung tin nhận được không thay đổi.
+// Lưới vị trí được cập nhật định kỳ và ngay khi một PHY đổi hướng (CourseChange),
+// nên giữa hai lần cập nhật vận tốc không đổi và độ lệch vị trí bị chặn.
+class CulledWifiChannel : public YansWifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CulledWifiChannel ();
+
+  // Che hàm của lớp cha để giữ lại mô hình dùng cho việc lọc
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+
+  void SetMarginDb (double marginDb);
+  void SetRefreshInterval (Time interval);
+
+  void SendCulled (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm);
+
+  uint64_t GetScheduledReceptions (void) const;
+  uint64_t GetSkippedReceptions (void) const;
+  // Phạm vi lớn nhất đã tính (m), 0 nếu chưa có lần phát nào
+  double GetMaxRange (void) const;
+
+private:
+  void RefreshIndex (void);
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  double GetRange (double txPowerDbm);
+  static void Receive (Ptr<YansWifiPhy> phy, Ptr<WifiPpdu> ppdu, double rxPowerDbm);
+
+  Ptr<PropagationLossModel>       m_loss;
+  Ptr<PropagationDelayModel>      m_delay;
+  std::vector<Ptr<YansWifiPhy> >  m_phys;          // cùng thứ tự với danh sách PHY của kênh gốc
+  SpatialGrid                     m_grid;
+  std::vector<uint32_t>           m_candidates;
+  std::map<double, double>        m_ranges;        // công suất phát (dBm) -> phạm vi (m)
+  double                          m_marginDb;
+  Time                            m_refreshInterval;
+  Time                            m_lastRefresh;
+  double                          m_maxSpeed;      // m/s tại lần cập nhật lưới gần nhất
+  bool                            m_courseChanged; // có PHY đổi vận tốc/vị trí sau lần cập nhật
+  uint64_t                        m_scheduled;
+  uint64_t                        m_skipped;
+};
+
+// YansWifiPhy gửi qua CulledWifiChannel::SendCulled khi được gắn vào kênh đó
+class CulledYansWifiPhy : public YansWifiPhy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual void StartTx (Ptr<const WifiPpdu> ppdu);
+};
+
+// YansWifiPhyHelper tạo CulledYansWifiPhy khi bật lọc theo phạm vi
+class CulledYansWifiPhyHelper : public YansWifiPhyHelper
+{
+public:
+  void EnableCulling (void);
+};
+
+// Tạo CulledWifiChannel với cùng mô hình suy hao/trễ mà helper cấu hình
+Ptr<CulledWifiChannel> CreateCulledChannel (YansWifiChannelHelper &helper);
+
+// Khoảng cách xa nhất (m) mà công suất nhận theo mô hình suy hao chưa xuống
+// dưới ngưỡng, vô hạn nếu vượt 1000 km. Giả thiết suy hao tăng theo khoảng cách.
+double FindLossRange (Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm);
+// Phạm vi giải mã của thiết bị Wi-Fi trên kênh Yans, tính từ chính mô hình suy
+// hao của kênh và công suất phát, độ lợi, độ nhạy, độ rộng kênh của PHY
+double GetDecodableRange (Ptr<WifiNetDevice> device);
+
+NS_OBJECT_ENSURE_REGISTERED (CulledWifiChannel);
+NS_OBJECT_ENSURE_REGISTERED (CulledYansWifiPhy);
+
+TypeId
+CulledWifiChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CulledWifiChannel")
+    .SetParent<YansWifiChannel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CulledWifiChannel> ()
+  ;
+  return tid;
+}
+
+CulledWifiChannel::CulledWifiChannel ()
+  : m_loss (0),
+    m_delay (0),
+    m_grid (),
+    m_marginDb (10.0),
+    m_refreshInterval (MilliSeconds (100)),
+    m_lastRefresh (),
+    m_maxSpeed (0.0),
+    m_courseChanged (false),
+    m_scheduled (0),
+    m_skipped (0)
+{
+}
+
+void
+CulledWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
+{
+  YansWifiChannel::SetPropagationLossModel (loss);
+  m_loss = loss;
+  m_ranges.clear ();
+}
+
+void
+CulledWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
+{
+  YansWifiChannel::SetPropagationDelayModel (delay);
+  m_delay = delay;
+}
+
+void
+CulledWifiChannel::SetMarginDb (double marginDb)
+{
+  m_marginDb = marginDb;
+  m_ranges.clear ();
+}
+
+void
+CulledWifiChannel::SetRefreshInterval (Time interval)
+{
+  m_refreshInterval = interval;
+}
+
+void
+CulledWifiChannel::SendCulled (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm)
+{
+  if (m_phys.size () != GetNDevices () || m_courseChanged
+      || Simulator::Now () - m_lastRefresh >= m_refreshInterval)
+    {
+      RefreshIndex ();
+    }
+
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  double range = GetRange (txPowerDbm);
+  if (std::isinf (range))
+    {
+      // Không chặn được phạm vi: xét mọi PHY như kênh gốc
+      m_candidates.resize (m_phys.size ());
+      for (uint32_t i = 0; i < m_phys.size (); i++)
+        {
+          m_candidates[i] = i;
+        }
+    }
+  else
+    {
+      // Vận tốc không đổi từ lần cập nhật (đổi hướng buộc cập nhật lại) nên
+      // vị trí trong lưới lệch tối đa maxSpeed * thời gian từ lần cập nhật
+      double slack = m_maxSpeed * (Simulator::Now () - m_lastRefresh).GetSeconds ();
+      m_grid.QueryRadius (senderMobility->GetPosition (), range + slack, m_candidates);
+    }
+  m_skipped += m_phys.size () - m_candidates.size ();
+
+  // Các chỉ số tăng dần nên thứ tự lập lịch giống YansWifiChannel::Send
+  for (uint32_t i : m_candidates)
+    {
+      Ptr<YansWifiPhy> receiver = m_phys[i];
+      if (receiver == sender)
+        {
+          continue;
+        }
+      // Như kênh gốc: chưa xét nhiễu giữa các kênh và ghép kênh
+      if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+        {
+          continue;
+        }
+      Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+      Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      Ptr<WifiPpdu> copy = ppdu->Copy ();
+      Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+      uint32_t dstNode = dstNetDevice ? dstNetDevice->GetNode ()->GetId () : 0xffffffff;
+      Simulator::ScheduleWithContext (dstNode, delay, &CulledWifiChannel::Receive,
+                                      receiver, copy, rxPowerDbm);
+      m_scheduled++;
+    }
+}
+
+uint64_t
+CulledWifiChannel::GetScheduledReceptions (void) const
+{
+  return m_scheduled;
+}
+
+uint64_t
+CulledWifiChannel::GetSkippedReceptions (void) const
+{
+  return m_skipped;
+}
+
+double
+CulledWifiChannel::GetMaxRange (void) const
+{
+  double range = 0.0;
+  for (const std::pair<const double, double> &entry : m_ranges)
+    {
+      range = std::max (range, entry.second);
+    }
+  return range;
+}
+
+void
+CulledWifiChannel::RefreshIndex (void)
+{
+  if (m_phys.size () != GetNDevices ())
+    {
+      // Kênh gốc chỉ thêm PHY vào cuối danh sách nên chỉ cần đăng ký cho PHY mới
+      uint32_t known = m_phys.size ();
+      m_phys.clear ();
+      m_grid.Clear ();
+      for (uint32_t i = 0; i < GetNDevices (); i++)
+        {
+          Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (GetDevice (i));
+          m_phys.push_back (DynamicCast<YansWifiPhy> (device->GetPhy ()));
+          if (i >= known)
+            {
+              m_phys[i]->GetMobility ()->TraceConnectWithoutContext (
+                "CourseChange", MakeCallback (&CulledWifiChannel::CourseChanged, this));
+            }
+        }
+    }
+
+  m_maxSpeed = 0.0;
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phys[i]->GetMobility ();
+      m_grid.Update (i, mobility->GetPosition ());
+      Vector v = mobility->GetVelocity ();
+      m_maxSpeed = std::max (m_maxSpeed, std::sqrt (v.x * v.x + v.y * v.y + v.z * v.z));
+    }
+  m_lastRefresh = Simulator::Now ();
+  m_courseChanged = false;
+}
+
+void
+CulledWifiChannel::CourseChanged (Ptr<const MobilityModel> /* mobility */)
+{
+  m_courseChanged = true;
+}
+
+double
+CulledWifiChannel::GetRange (double txPowerDbm)
+{
+  std::map<double, double>::const_iterator it = m_ranges.find (txPowerDbm);
+  if (it != m_ranges.end ())
+    {
+      return it->second;
+    }
+
+  // Ngưỡng thấp nhất mà Receive còn chấp nhận: độ nhạy trừ độ lợi thu,
+  // hiệu chỉnh cho độ rộng kênh hẹp nhất (5 MHz) và thêm biên an toàn
+  double thresholdDbm = std::numeric_limits<double>::max ();
+  for (Ptr<YansWifiPhy> phy : m_phys)
+    {
+      thresholdDbm = std::min (thresholdDbm, phy->GetRxSensitivity () - phy->GetRxGain ());
+    }
+  thresholdDbm += RatioToDb (5.0 / 20.0) - m_marginDb;
+
+  double range = FindLossRange (m_loss, txPowerDbm, thresholdDbm);
+  m_ranges[txPowerDbm] = range;
+  if (m_ranges.size () == 1 && !std::isinf (range))
+    {
+      // Ô lưới bằng phạm vi: truy vấn bán kính chỉ chạm khoảng 3x3 ô
+      m_grid.SetCellSize (range);
+    }
+  return range;
+}
+
+void
+CulledWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<WifiPpdu> ppdu, double rxPowerDbm)
+{
+  // Giống YansWifiChannel::Receive
+  uint16_t txWidth = ppdu->GetTransmissionChannelWidth ();
+  if ((rxPowerDbm + phy->GetRxGain ()) < phy->GetRxSensitivity () + RatioToDb (txWidth / 20.0))
+    {
+      return;
+    }
+  RxPowerWattPerChannelBand rxPowerW;
+  rxPowerW.insert ({std::make_pair (0, 0), (DbmToW (rxPowerDbm + phy->GetRxGain ()))});
+  phy->StartReceivePreamble (ppdu, rxPowerW, ppdu->GetTxDuration ());
+}
+
+TypeId
+CulledYansWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CulledYansWifiPhy")
+    .SetParent<YansWifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CulledYansWifiPhy> ()
+  ;
+  return tid;
+}
+
+void
+CulledYansWifiPhy::StartTx (Ptr<const WifiPpdu> ppdu)
+{
+  Ptr<CulledWifiChannel> channel = DynamicCast<CulledWifiChannel> (GetChannel ());
+  if (!channel)
+    {
+      YansWifiPhy::StartTx (ppdu);
+      return;
+    }
+  channel->SendCulled (this, ppdu, GetTxPowerForTransmission (ppdu) + GetTxGain ());
+}
+
+void
+CulledYansWifiPhyHelper::EnableCulling (void)
+{
+  m_phy.SetTypeId ("ns3::CulledYansWifiPhy");
+}
+
+Ptr<CulledWifiChannel>
+CreateCulledChannel (YansWifiChannelHelper &helper)
+{
+  // Helper không cho lấy factory nên đọc lại mô hình từ kênh mẫu qua thuộc tính
+  Ptr<YansWifiChannel> reference = helper.Create ();
+  PointerValue loss;
+  PointerValue delay;
+  reference->GetAttribute ("PropagationLossModel", loss);
+  reference->GetAttribute ("PropagationDelayModel", delay);
+
+  Ptr<CulledWifiChannel> channel = CreateObject<CulledWifiChannel> ();
+  channel->SetPropagationLossModel (loss.Get<PropagationLossModel> ());
+  channel->SetPropagationDelayModel (delay.Get<PropagationDelayModel> ());
+  return channel;
+}
+
+double
+FindLossRange (Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm)
+{
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+
+  // Tìm khoảng cách đầu tiên có công suất nhận dưới ngưỡng rồi chia đôi
+  double hi = 1.0;
+  b->SetPosition (Vector (hi, 0, 0));
+  while (loss->CalcRxPower (txPowerDbm, a, b) >= thresholdDbm)
+    {
+      hi *= 2;
+      if (hi > 1e6)
+        {
+          return std::numeric_limits<double>::infinity ();
+        }
+      b->SetPosition (Vector (hi, 0, 0));
+    }
+  double lo = 0.0;
+  while (hi - lo > 0.01)
+    {
+      double mid = (lo + hi) / 2;
+      b->SetPosition (Vector (mid, 0, 0));
+      if (loss->CalcRxPower (txPowerDbm, a, b) >= thresholdDbm)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+  return hi;
+}
+
+double
+GetDecodableRange (Ptr<WifiNetDevice> device)
+{
+  Ptr<YansWifiPhy> phy = DynamicCast<YansWifiPhy> (device->GetPhy ());
+  NS_ABORT_MSG_UNLESS (phy, "Radio range needs a YansWifiPhy");
+  PointerValue loss;
+  phy->GetChannel ()->GetAttribute ("PropagationLossModel", loss);
+  NS_ABORT_MSG_UNLESS (loss.Get<PropagationLossModel> (), "Radio range needs a propagation loss model");
+
+  // Cùng điều kiện với YansWifiChannel::Receive ở độ rộng kênh đang dùng
+  double txPowerDbm = phy->GetTxPowerEnd () + phy->GetTxGain ();
+  double thresholdDbm = phy->GetRxSensitivity () - phy->GetRxGain ()
+                        + RatioToDb (phy->GetChannelWidth () / 20.0);
+  return FindLossRange (loss.Get<PropagationLossModel> (), txPowerDbm, thresholdDbm);
+}
+
+#endif /* CULLEDCHANNEL_H */
@@ -0,0 +1,285 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace ns3;
+
+
+class FleetMobilityModel;
+
+// Di chuyển vận tốc không đổi cho cả đoàn xe, lưu dạng mảng theo thành phần
+// (x, y, z, vx, vy, vz, thời điểm gốc) thay cho một ConstantVelocityMobilityModel
+// mỗi xe. Vị trí được tính khi cần từ vị trí gốc + vận tốc * thời gian trôi qua,
+// truy vấn không ghi lại trạng thái. Thay đổi vận tốc hàng loạt (dừng tất cả,
+// đổi hướng tất cả) chạy trên các mảng liền nhau.
+// Mỗi node vẫn có một FleetMobilityModel để PHY, NetAnim dùng như MobilityModel.
+class FleetMobility
+{
+public:
+  FleetMobility ();
+
+  // Gắn FleetMobilityModel vào từng node, vị trí ban đầu lấy từ allocator
+  void Install (NodeContainer nodes, Ptr<PositionAllocator> allocator);
+  // Trả về chỉ số của xe trong đoàn
+  uint32_t Add (Ptr<Node> node, const Vector &position);
+
+  uint32_t GetN (void) const;
+  Vector GetPosition (uint32_t i) const;
+  Vector GetVelocity (uint32_t i) const;
+  void SetPosition (uint32_t i, const Vector &position);
+  void SetVelocity (uint32_t i, const Vector &velocity);
+
+  // Vị trí hiện tại của mọi xe, theo chỉ số
+  void GetPositions (std::vector<Vector> &positions) const;
+  void StopAll (void);
+  // velocities[i] là vận tốc mới của xe i
+  void SetVelocities (const std::vector<Vector> &velocities);
+
+private:
+  // Dồn quãng đường đã đi vào vị trí gốc để đổi vận tốc từ thời điểm now
+  void Rebase (uint32_t i, double now);
+  void RebaseAll (double now);
+  void NotifyAll (void);
+
+  std::vector<double>               m_x;
+  std::vector<double>               m_y;
+  std::vector<double>               m_z;
+  std::vector<double>               m_vx;
+  std::vector<double>               m_vy;
+  std::vector<double>               m_vz;
+  std::vector<double>               m_t;       // thời điểm (s) ứng với vị trí gốc
+  std::vector<FleetMobilityModel *> m_models;  // node giữ tham chiếu tới model
+};
+
+// MobilityModel của một xe, đọc/ghi trạng thái trong FleetMobility
+class FleetMobilityModel : public MobilityModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  FleetMobilityModel ();
+
+  void SetFleet (FleetMobility *fleet, uint32_t index);
+  uint32_t GetIndex (void) const;
+  // Báo CourseChange sau khi đoàn xe đổi vận tốc hàng loạt
+  void NotifyFleetChange (void);
+
+private:
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+
+  FleetMobility *m_fleet;
+  uint32_t       m_index;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (FleetMobilityModel);
+
+FleetMobility::FleetMobility ()
+{
+}
+
+void
+FleetMobility::Install (NodeContainer nodes, Ptr<PositionAllocator> allocator)
+{
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      Add (*it, allocator->GetNext ());
+    }
+}
+
+uint32_t
+FleetMobility::Add (Ptr<Node> node, const Vector &position)
+{
+  uint32_t index = m_x.size ();
+  m_x.push_back (position.x);
+  m_y.push_back (position.y);
+  m_z.push_back (position.z);
+  m_vx.push_back (0.0);
+  m_vy.push_back (0.0);
+  m_vz.push_back (0.0);
+  m_t.push_back (Simulator::Now ().GetSeconds ());
+
+  Ptr<FleetMobilityModel> model = CreateObject<FleetMobilityModel> ();
+  model->SetFleet (this, index);
+  node->AggregateObject (model);
+  m_models.push_back (PeekPointer (model));
+  return index;
+}
+
+uint32_t
+FleetMobility::GetN (void) const
+{
+  return m_x.size ();
+}
+
+Vector
+FleetMobility::GetPosition (uint32_t i) const
+{
+  double dt = Simulator::Now ().GetSeconds () - m_t[i];
+  return Vector (m_x[i] + m_vx[i] * dt, m_y[i] + m_vy[i] * dt, m_z[i] + m_vz[i] * dt);
+}
+
+Vector
+FleetMobility::GetVelocity (uint32_t i) const
+{
+  return Vector (m_vx[i], m_vy[i], m_vz[i]);
+}
+
+void
+FleetMobility::SetPosition (uint32_t i, const Vector &position)
+{
+  m_x[i] = position.x;
+  m_y[i] = position.y;
+  m_z[i] = position.z;
+  m_t[i] = Simulator::Now ().GetSeconds ();
+  m_models[i]->NotifyFleetChange ();
+}
+
+void
+FleetMobility::SetVelocity (uint32_t i, const Vector &velocity)
+{
+  Rebase (i, Simulator::Now ().GetSeconds ());
+  m_vx[i] = velocity.x;
+  m_vy[i] = velocity.y;
+  m_vz[i] = velocity.z;
+  m_models[i]->NotifyFleetChange ();
+}
+
+void
+FleetMobility::GetPositions (std::vector<Vector> &positions) const
+{
+  double now = Simulator::Now ().GetSeconds ();
+  positions.resize (m_x.size ());
+  for (uint32_t i = 0; i < m_x.size (); i++)
+    {
+      double dt = now - m_t[i];
+      positions[i] = Vector (m_x[i] + m_vx[i] * dt, m_y[i] + m_vy[i] * dt, m_z[i] + m_vz[i] * dt);
+    }
+}
+
+void
+FleetMobility::StopAll (void)
+{
+  RebaseAll (Simulator::Now ().GetSeconds ());
+  std::fill (m_vx.begin (), m_vx.end (), 0.0);
+  std::fill (m_vy.begin (), m_vy.end (), 0.0);
+  std::fill (m_vz.begin (), m_vz.end (), 0.0);
+  NotifyAll ();
+}
+
+void
+FleetMobility::SetVelocities (const std::vector<Vector> &velocities)
+{
+  NS_ABORT_MSG_IF (velocities.size () != m_x.size (), "Need one velocity per vehicle");
+  RebaseAll (Simulator::Now ().GetSeconds ());
+  for (uint32_t i = 0; i < velocities.size (); i++)
+    {
+      m_vx[i] = velocities[i].x;
+      m_vy[i] = velocities[i].y;
+      m_vz[i] = velocities[i].z;
+    }
+  NotifyAll ();
+}
+
+void
+FleetMobility::Rebase (uint32_t i, double now)
+{
+  double dt = now - m_t[i];
+  m_x[i] += m_vx[i] * dt;
+  m_y[i] += m_vy[i] * dt;
+  m_z[i] += m_vz[i] * dt;
+  m_t[i] = now;
+}
+
+void
+FleetMobility::RebaseAll (double now)
+{
+  // Các vòng lặp riêng theo từng mảng để trình biên dịch vector hóa
+  uint32_t n = m_x.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_x[i] += m_vx[i] * (now - m_t[i]);
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_y[i] += m_vy[i] * (now - m_t[i]);
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_z[i] += m_vz[i] * (now - m_t[i]);
+    }
+  std::fill (m_t.begin (), m_t.end (), now);
+}
+
+void
+FleetMobility::NotifyAll (void)
+{
+  for (FleetMobilityModel *model : m_models)
+    {
+      model->NotifyFleetChange ();
+    }
+}
+
+TypeId
+FleetMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FleetMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<FleetMobilityModel> ()
+  ;
+  return tid;
+}
+
+FleetMobilityModel::FleetMobilityModel ()
+  : m_fleet (0),
+    m_index (0)
+{
+}
+
+void
+FleetMobilityModel::SetFleet (FleetMobility *fleet, uint32_t index)
+{
+  m_fleet = fleet;
+  m_index = index;
+}
+
+uint32_t
+FleetMobilityModel::GetIndex (void) const
+{
+  return m_index;
+}
+
+void
+FleetMobilityModel::NotifyFleetChange (void)
+{
+  NotifyCourseChange ();
+}
+
+Vector
+FleetMobilityModel::DoGetPosition (void) const
+{
+  return m_fleet->GetPosition (m_index);
+}
+
+void
+FleetMobilityModel::DoSetPosition (const Vector &position)
+{
+  m_fleet->SetPosition (m_index, position);
+}
+
+Vector
+FleetMobilityModel::DoGetVelocity (void) const
+{
+  return m_fleet->GetVelocity (m_index);
+}
+
+#endif /* FLEET_H */
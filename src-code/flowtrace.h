@@ -0,0 +1,215 @@
+#ifndef FLOWTRACE_H
+#define FLOWTRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Định dạng nhị phân chuỗi thời gian theo từng flow (.vft).
+// Phần này không phụ thuộc ns-3 để công cụ đọc/chuyển đổi biên dịch riêng được.
+//
+// File = FlowTraceHeader, sau đó là các khối nối tiếp nhau:
+//   FlowTraceChunk (type, count, time) + count bản ghi kích thước cố định.
+//   FLOWTRACE_TUPLES:  FlowTraceTuple cho các flow mới xuất hiện trong lần lấy mẫu
+//   FLOWTRACE_RECORDS: FlowTraceRecord của các flow có bộ đếm thay đổi
+// Bộ đếm trong bản ghi là giá trị cộng dồn như FlowMonitor::FlowStats; flow không
+// có bản ghi trong một lần lấy mẫu thì giữ giá trị của lần trước.
+// Số nguyên và số thực ghi theo thứ tự byte của máy (little-endian trên x86/ARM).
+
+const char FLOWTRACE_MAGIC[4] = { 'V', 'F', 'T', '1' };
+const uint32_t FLOWTRACE_VERSION = 1;
+
+enum FlowTraceChunkType
+{
+  FLOWTRACE_TUPLES = 1,
+  FLOWTRACE_RECORDS = 2
+};
+
+#pragma pack(push, 1)
+struct FlowTraceHeader
+{
+  char     magic[4];
+  uint32_t version;
+  uint32_t tupleSize;      // sizeof (FlowTraceTuple) lúc ghi
+  uint32_t recordSize;     // sizeof (FlowTraceRecord) lúc ghi
+};
+
+struct FlowTraceChunk
+{
+  uint32_t type;
+  uint32_t count;
+  double   time;           // thời điểm lấy mẫu (s)
+};
+
+struct FlowTraceTuple
+{
+  uint32_t index;          // chỉ số trong bảng five-tuple, theo thứ tự xuất hiện
+  uint32_t flowId;
+  uint32_t source;         // địa chỉ IPv4 dạng số
+  uint32_t destination;
+  uint16_t sourcePort;
+  uint16_t destinationPort;
+  uint8_t  protocol;
+  uint8_t  reserved[3];
+};
+
+struct FlowTraceRecord
+{
+  uint32_t flowId;
+  uint32_t tupleIndex;
+  uint64_t txPackets;
+  uint64_t rxPackets;
+  uint64_t txBytes;
+  uint64_t rxBytes;
+  uint64_t lostPackets;
+  int64_t  delaySum;       // ns
+  int64_t  jitterSum;      // ns
+};
+#pragma pack(pop)
+
+// Đọc tuần tự từng khối. Bản ghi được đọc thẳng vào mảng, không phân tích văn bản.
+class FlowTraceReader
+{
+public:
+  FlowTraceReader ();
+  ~FlowTraceReader ();
+
+  bool Open (const std::string &path);
+  void Close (void);
+
+  // Đọc lần lấy mẫu tiếp theo: tuples nhận các flow mới, records nhận bản ghi.
+  // Trả về false khi hết file hoặc file hỏng.
+  bool Next (double &time, std::vector<FlowTraceTuple> &tuples, std::vector<FlowTraceRecord> &records);
+  const std::string &GetError (void) const;
+
+private:
+  bool ReadChunk (FlowTraceChunk &chunk);
+
+  std::FILE     *m_file;
+  std::string    m_error;
+  FlowTraceChunk m_peek;       // khối đã đọc header nhưng thuộc lần lấy mẫu sau
+  bool           m_hasPeek;
+};
+
+FlowTraceReader::FlowTraceReader ()
+  : m_file (0),
+    m_hasPeek (false)
+{
+}
+
+FlowTraceReader::~FlowTraceReader ()
+{
+  Close ();
+}
+
+bool
+FlowTraceReader::Open (const std::string &path)
+{
+  Close ();
+  m_file = std::fopen (path.c_str (), "rb");
+  if (!m_file)
+    {
+      m_error = "cannot open " + path;
+      return false;
+    }
+  FlowTraceHeader header;
+  if (std::fread (&header, sizeof (header), 1, m_file) != 1
+      || std::memcmp (header.magic, FLOWTRACE_MAGIC, sizeof (header.magic)) != 0)
+    {
+      m_error = path + " is not a flow trace";
+      Close ();
+      return false;
+    }
+  if (header.version != FLOWTRACE_VERSION
+      || header.tupleSize != sizeof (FlowTraceTuple)
+      || header.recordSize != sizeof (FlowTraceRecord))
+    {
+      m_error = path + " has an unsupported flow trace version";
+      Close ();
+      return false;
+    }
+  return true;
+}
+
+void
+FlowTraceReader::Close (void)
+{
+  if (m_file)
+    {
+      std::fclose (m_file);
+      m_file = 0;
+    }
+  m_hasPeek = false;
+}
+
+const std::string &
+FlowTraceReader::GetError (void) const
+{
+  return m_error;
+}
+
+bool
+FlowTraceReader::ReadChunk (FlowTraceChunk &chunk)
+{
+  if (m_hasPeek)
+    {
+      chunk = m_peek;
+      m_hasPeek = false;
+      return true;
+    }
+  return m_file && std::fread (&chunk, sizeof (chunk), 1, m_file) == 1;
+}
+
+bool
+FlowTraceReader::Next (double &time, std::vector<FlowTraceTuple> &tuples, std::vector<FlowTraceRecord> &records)
+{
+  tuples.clear ();
+  records.clear ();
+  FlowTraceChunk chunk;
+  if (!ReadChunk (chunk))
+    {
+      return false;
+    }
+  time = chunk.time;
+  // Các khối cùng thời điểm thuộc cùng một lần lấy mẫu
+  while (true)
+    {
+      std::size_t read;
+      if (chunk.type == FLOWTRACE_TUPLES)
+        {
+          std::size_t offset = tuples.size ();
+          tuples.resize (offset + chunk.count);
+          read = std::fread (tuples.data () + offset, sizeof (FlowTraceTuple), chunk.count, m_file);
+        }
+      else if (chunk.type == FLOWTRACE_RECORDS)
+        {
+          std::size_t offset = records.size ();
+          records.resize (offset + chunk.count);
+          read = std::fread (records.data () + offset, sizeof (FlowTraceRecord), chunk.count, m_file);
+        }
+      else
+        {
+          m_error = "unknown chunk type " + std::to_string (chunk.type);
+          return false;
+        }
+      if (read != chunk.count)
+        {
+          m_error = "truncated chunk";
+          return false;
+        }
+      if (!ReadChunk (chunk))
+        {
+          return true;
+        }
+      if (chunk.time != time)
+        {
+          m_peek = chunk;
+          m_hasPeek = true;
+          return true;
+        }
+    }
+}
+
+#endif /* FLOWTRACE_H */
@@ -0,0 +1,81 @@
+// Chuyển file chuỗi thời gian theo flow (--FlowTrace) sang CSV.
+// Không cần ns-3: g++ -std=c++17 -O2 -o flowtrace2csv flowtrace2csv.cc
+// Dùng: ./flowtrace2csv flows.vft [flows.csv]   (mặc định ghi ra stdout)
+#include "flowtrace.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static std::string
+FormatAddress (uint32_t address)
+{
+  return std::to_string ((address >> 24) & 0xff) + "." + std::to_string ((address >> 16) & 0xff) + "."
+         + std::to_string ((address >> 8) & 0xff) + "." + std::to_string (address & 0xff);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc < 2)
+    {
+      std::fprintf (stderr, "Usage: %s <trace.vft> [output.csv]\n", argv[0]);
+      return 1;
+    }
+
+  FlowTraceReader reader;
+  if (!reader.Open (argv[1]))
+    {
+      std::fprintf (stderr, "%s\n", reader.GetError ().c_str ());
+      return 1;
+    }
+  std::FILE *out = argc > 2 ? std::fopen (argv[2], "w") : stdout;
+  if (!out)
+    {
+      std::fprintf (stderr, "cannot open %s\n", argv[2]);
+      return 1;
+    }
+
+  std::fprintf (out, "Time,FlowId,TupleIndex,Source,Destination,SourcePort,DestinationPort,Protocol,"
+                "TxPackets,RxPackets,TxBytes,RxBytes,LostPackets,DelaySum,JitterSum\n");
+  // Bảng five-tuple theo chỉ số, được bổ sung dần theo các khối TUPLES
+  std::vector<FlowTraceTuple> table;
+  std::vector<FlowTraceTuple> tuples;
+  std::vector<FlowTraceRecord> records;
+  double time;
+  uint64_t count = 0;
+  while (reader.Next (time, tuples, records))
+    {
+      for (const FlowTraceTuple &t : tuples)
+        {
+          if (t.index >= table.size ())
+            {
+              table.resize (t.index + 1);
+            }
+          table[t.index] = t;
+        }
+      for (const FlowTraceRecord &r : records)
+        {
+          const FlowTraceTuple &t = table[r.tupleIndex];
+          std::fprintf (out, "%g,%u,%u,%s,%s,%u,%u,%u,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.9f,%.9f\n",
+                        time, r.flowId, r.tupleIndex,
+                        FormatAddress (t.source).c_str (), FormatAddress (t.destination).c_str (),
+                        t.sourcePort, t.destinationPort, t.protocol,
+                        r.txPackets, r.rxPackets, r.txBytes, r.rxBytes, r.lostPackets,
+                        r.delaySum * 1e-9, r.jitterSum * 1e-9);
+        }
+      count += records.size ();
+    }
+  if (!reader.GetError ().empty ())
+    {
+      std::fprintf (stderr, "%s\n", reader.GetError ().c_str ());
+      return 1;
+    }
+  std::fprintf (stderr, "%" PRIu64 " bản ghi, %zu flow\n", count, table.size ());
+  if (out != stdout)
+    {
+      std::fclose (out);
+    }
+  return 0;
+}
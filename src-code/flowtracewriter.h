@@ -0,0 +1,167 @@
+#ifndef FLOWTRACEWRITER_H
+#define FLOWTRACEWRITER_H
+
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "flowtrace.h"
+#include "resultsink.h"
+
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+
+// Ghi chuỗi thời gian theo từng flow ở định dạng flowtrace.h. MetricsEngine gọi Add
+// cho mỗi flow thay đổi trong một lần lấy mẫu, Flush đóng gói thành khối nhị phân
+// và giao cho ResultSink ghi ở luồng nền. Trước khi Open (chế độ fork) các khối
+// được giữ trong bộ nhớ và ghi ra khi tiến trình con mở file.
+class FlowTraceWriter
+{
+public:
+  FlowTraceWriter ();
+
+  bool Open (const std::string &path);
+  bool IsEnabled (void) const;
+  void Enable (void);
+  void Add (FlowId id, const Ipv4FlowClassifier::FiveTuple &tuple, const FlowMonitor::FlowStats &st);
+  void Flush (Time now);
+  void Close (void);
+
+  uint64_t GetRecordCount (void) const;
+
+private:
+  template <typename T>
+  void AppendChunk (uint32_t type, double time, const std::vector<T> &entries);
+
+  bool                          m_enabled;
+  ResultSink                    m_sink;
+  std::string                   m_pending;      // các khối chưa có file để ghi
+  std::vector<int64_t>          m_tupleIndex;   // FlowId -> chỉ số five-tuple, -1 nếu chưa có
+  uint32_t                      m_tupleCount;
+  std::vector<FlowTraceTuple>   m_newTuples;
+  std::vector<FlowTraceRecord>  m_records;
+  uint64_t                      m_recordCount;
+};
+
+FlowTraceWriter::FlowTraceWriter ()
+  : m_enabled (false),
+    m_tupleCount (0),
+    m_recordCount (0)
+{
+}
+
+void
+FlowTraceWriter::Enable (void)
+{
+  m_enabled = true;
+}
+
+bool
+FlowTraceWriter::IsEnabled (void) const
+{
+  return m_enabled;
+}
+
+bool
+FlowTraceWriter::Open (const std::string &path)
+{
+  if (!m_sink.Open (path))
+    {
+      return false;
+    }
+  m_enabled = true;
+  FlowTraceHeader header;
+  std::memcpy (header.magic, FLOWTRACE_MAGIC, sizeof (header.magic));
+  header.version = FLOWTRACE_VERSION;
+  header.tupleSize = sizeof (FlowTraceTuple);
+  header.recordSize = sizeof (FlowTraceRecord);
+  m_sink.Write (std::string (reinterpret_cast<const char *> (&header), sizeof (header)));
+  m_sink.Write (m_pending);
+  m_pending.clear ();
+  return true;
+}
+
+void
+FlowTraceWriter::Add (FlowId id, const Ipv4FlowClassifier::FiveTuple &tuple, const FlowMonitor::FlowStats &st)
+{
+  if (id >= m_tupleIndex.size ())
+    {
+      m_tupleIndex.resize (id + 1, -1);
+    }
+  if (m_tupleIndex[id] < 0)
+    {
+      FlowTraceTuple t;
+      std::memset (&t, 0, sizeof (t));
+      t.index = m_tupleCount;
+      t.flowId = id;
+      t.source = tuple.sourceAddress.Get ();
+      t.destination = tuple.destinationAddress.Get ();
+      t.sourcePort = tuple.sourcePort;
+      t.destinationPort = tuple.destinationPort;
+      t.protocol = tuple.protocol;
+      m_newTuples.push_back (t);
+      m_tupleIndex[id] = m_tupleCount++;
+    }
+
+  FlowTraceRecord r;
+  r.flowId = id;
+  r.tupleIndex = m_tupleIndex[id];
+  r.txPackets = st.txPackets;
+  r.rxPackets = st.rxPackets;
+  r.txBytes = st.txBytes;
+  r.rxBytes = st.rxBytes;
+  r.lostPackets = st.lostPackets;
+  r.delaySum = st.delaySum.GetNanoSeconds ();
+  r.jitterSum = st.jitterSum.GetNanoSeconds ();
+  m_records.push_back (r);
+}
+
+template <typename T>
+void
+FlowTraceWriter::AppendChunk (uint32_t type, double time, const std::vector<T> &entries)
+{
+  if (entries.empty ())
+    {
+      return;
+    }
+  FlowTraceChunk chunk;
+  chunk.type = type;
+  chunk.count = entries.size ();
+  chunk.time = time;
+  std::string data (reinterpret_cast<const char *> (&chunk), sizeof (chunk));
+  data.append (reinterpret_cast<const char *> (entries.data ()), entries.size () * sizeof (T));
+  if (m_sink.IsOpen ())
+    {
+      m_sink.Write (data);
+    }
+  else
+    {
+      m_pending += data;
+    }
+}
+
+void
+FlowTraceWriter::Flush (Time now)
+{
+  double time = now.GetSeconds ();
+  AppendChunk (FLOWTRACE_TUPLES, time, m_newTuples);
+  AppendChunk (FLOWTRACE_RECORDS, time, m_records);
+  m_recordCount += m_records.size ();
+  m_newTuples.clear ();
+  m_records.clear ();
+}
+
+void
+FlowTraceWriter::Close (void)
+{
+  m_sink.Close ();
+}
+
+uint64_t
+FlowTraceWriter::GetRecordCount (void) const
+{
+  return m_recordCount;
+}
+
+#endif /* FLOWTRACEWRITER_H */
@@ -0,0 +1,491 @@
+#ifndef HANDOVER_H
+#define HANDOVER_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "fleet.h"
+#include "spatial.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+
+// Theo dõi RSU phục vụ của từng xe từ vị trí và vận tốc trong FleetMobility.
+// RSU hiện tại là RSU gần nhất (có trễ HandoverHysteresis để không đổi qua lại
+// ở ranh giới); RSU kế tiếp là RSU gần nhất tại vị trí ngoại suy sau Horizon.
+// Khi RSU kế tiếp khác RSU hiện tại, callback dự đoán được gọi một lần để
+// controller cài sẵn đường đi (gọi lại với -1 nếu dự đoán bị hủy); khi RSU hiện
+// tại đổi, callback handover được gọi.
+class AssociationTracker
+{
+public:
+  // (xe, RSU hiện tại, RSU mới hoặc RSU dự đoán); -1 là chưa có RSU
+  typedef Callback<void, uint32_t, int32_t, int32_t> AssociationCallback;
+
+  AssociationTracker ();
+
+  void Setup (FleetMobility *fleet, const std::vector<Vector> &rsuPositions);
+  void SetInterval (Time interval);
+  void SetHorizon (Time horizon);
+  void SetHysteresis (double meters);
+  void SetHandoverCallback (AssociationCallback callback);
+  void SetPredictionCallback (AssociationCallback callback);
+  void Start (void);
+
+  int32_t GetCurrent (uint32_t vehicle) const;
+  int32_t GetPredicted (uint32_t vehicle) const;
+  uint64_t GetHandoverCount (void) const;
+  // Số handover có RSU đích đã được dự đoán trước
+  uint64_t GetPredictedHandoverCount (void) const;
+
+private:
+  void Update (void);
+  // RSU gần nhất, giữ RSU hiện tại nếu RSU mới không gần hơn quá hysteresis
+  int32_t Select (const Vector &position, int32_t current) const;
+
+  FleetMobility        *m_fleet;
+  std::vector<Vector>   m_rsuPositions;
+  SpatialGrid           m_rsuGrid;
+  Time                  m_interval;
+  Time                  m_horizon;
+  double                m_hysteresis;
+  AssociationCallback   m_handover;
+  AssociationCallback   m_prediction;
+  std::vector<int32_t>  m_current;
+  std::vector<int32_t>  m_predicted;
+  uint64_t              m_handovers;
+  uint64_t              m_predictedHandovers;
+  std::vector<Vector>   m_positions;
+};
+
+// Tag gắn vào gói V2I khi rời node nguồn (như tag của Ipv4FlowProbe)
+class HandoverTag : public Tag
+{
+public:
+  HandoverTag ();
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+
+  void SetFlow (uint32_t flow);
+  uint32_t GetFlow (void) const;
+  void SetSeq (uint32_t seq);
+  uint32_t GetSeq (void) const;
+
+private:
+  uint32_t m_flow;
+  uint32_t m_seq;
+};
+
+// Đo ảnh hưởng của handover lên lưu lượng V2I giữa từng xe và server, theo
+// hai chiều: lên (xe -> server) và xuống (server -> xe). Mỗi gói được đánh số
+// ở IP của node nguồn (SendOutgoing) và ghi thời điểm nhận ở IP của node đích
+// (LocalDeliver). Với mỗi handover lúc t:
+//  - thời gian gián đoạn = gói nhận đầu tiên sau t - gói nhận cuối cùng trước t
+//    (gồm cả chu kỳ gửi gói bình thường)
+//  - số gói mất = các gói gửi giữa hai gói đó mà không tới đích
+// t là thời điểm AssociationTracker đổi RSU. Đường xuống đi theo luật switch
+// cài đúng lúc đó, còn đường lên do định tuyến vô tuyến tự chọn RSU ra nên có
+// thể đổi ở thời điểm khác; số liệu chiều lên chỉ là xấp xỉ.
+class HandoverMonitor
+{
+public:
+  HandoverMonitor ();
+
+  void AddServer (Ptr<Node> server, Ipv4Address address);
+  void AddVehicle (Ptr<Node> vehicle, Ipv4Address address);
+  void NotifyHandover (uint32_t vehicle, Time time);
+  void Report (std::ostream &os) const;
+
+private:
+  enum Direction
+  {
+    UPLINK = 0,
+    DOWNLINK = 1
+  };
+
+  struct Flow
+  {
+    std::vector<double>    txTimes;     // theo số thứ tự
+    std::vector<double>    rxTimes;     // -1 nếu chưa nhận
+    std::vector<double>    arrivals;    // thời điểm nhận theo thứ tự đến
+    std::vector<uint32_t>  arrivalSeq;
+  };
+
+  void Send (uint32_t flow, Ptr<const Packet> packet);
+  void Receive (Ptr<const Packet> packet);
+
+  static void ServerSend (HandoverMonitor *monitor, const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface);
+  static void VehicleSend (HandoverMonitor *monitor, uint32_t vehicle, const Ipv4Header &header,
+                           Ptr<const Packet> packet, uint32_t interface);
+  static void Deliver (HandoverMonitor *monitor, const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface);
+
+  std::vector<Ipv4Address>                 m_serverAddresses;
+  std::unordered_map<uint32_t, uint32_t>   m_vehicleIndex;   // địa chỉ IP -> chỉ số xe
+  std::vector<Flow>                        m_flows;          // 2 * xe + chiều
+  std::vector<std::vector<double> >        m_handovers;      // theo xe
+};
+
+AssociationTracker::AssociationTracker ()
+  : m_fleet (0),
+    m_rsuGrid (100.0),
+    m_interval (MilliSeconds (100)),
+    m_horizon (Seconds (2)),
+    m_hysteresis (5.0),
+    m_handovers (0),
+    m_predictedHandovers (0)
+{
+}
+
+void
+AssociationTracker::Setup (FleetMobility *fleet, const std::vector<Vector> &rsuPositions)
+{
+  m_fleet = fleet;
+  m_rsuPositions = rsuPositions;
+  m_rsuGrid.Clear ();
+  for (uint32_t r = 0; r < rsuPositions.size (); r++)
+    {
+      m_rsuGrid.Insert (r, rsuPositions[r]);
+    }
+  m_current.assign (fleet->GetN (), -1);
+  m_predicted.assign (fleet->GetN (), -1);
+}
+
+void
+AssociationTracker::SetInterval (Time interval)
+{
+  m_interval = interval;
+}
+
+void
+AssociationTracker::SetHorizon (Time horizon)
+{
+  m_horizon = horizon;
+}
+
+void
+AssociationTracker::SetHysteresis (double meters)
+{
+  m_hysteresis = meters;
+}
+
+void
+AssociationTracker::SetHandoverCallback (AssociationCallback callback)
+{
+  m_handover = callback;
+}
+
+void
+AssociationTracker::SetPredictionCallback (AssociationCallback callback)
+{
+  m_prediction = callback;
+}
+
+void
+AssociationTracker::Start (void)
+{
+  Simulator::ScheduleNow (&AssociationTracker::Update, this);
+}
+
+int32_t
+AssociationTracker::Select (const Vector &position, int32_t current) const
+{
+  int32_t nearest = m_rsuGrid.Nearest (position);
+  if (current < 0 || nearest == current)
+    {
+      return nearest;
+    }
+  double stay = CalculateDistance (position, m_rsuPositions[current]);
+  double move = CalculateDistance (position, m_rsuPositions[nearest]);
+  return stay - move > m_hysteresis ? nearest : current;
+}
+
+void
+AssociationTracker::Update (void)
+{
+  m_fleet->GetPositions (m_positions);
+  double horizon = m_horizon.GetSeconds ();
+  for (uint32_t i = 0; i < m_positions.size (); i++)
+    {
+      int32_t previous = m_current[i];
+      int32_t current = Select (m_positions[i], previous);
+      if (current != previous)
+        {
+          m_current[i] = current;
+          if (previous >= 0)
+            {
+              m_handovers++;
+              m_predictedHandovers += m_predicted[i] == current;
+            }
+          m_predicted[i] = -1;
+          if (!m_handover.IsNull ())
+            {
+              m_handover (i, previous, current);
+            }
+        }
+
+      Vector velocity = m_fleet->GetVelocity (i);
+      Vector future (m_positions[i].x + velocity.x * horizon, m_positions[i].y + velocity.y * horizon, m_positions[i].z);
+      int32_t next = Select (future, current);
+      // Dự đoán mới, hoặc hủy dự đoán cũ (next = -1) khi xe đổi hướng
+      if (next == current)
+        {
+          next = -1;
+        }
+      if (next != m_predicted[i])
+        {
+          m_predicted[i] = next;
+          if (!m_prediction.IsNull ())
+            {
+              m_prediction (i, current, next);
+            }
+        }
+    }
+  Simulator::Schedule (m_interval, &AssociationTracker::Update, this);
+}
+
+int32_t
+AssociationTracker::GetCurrent (uint32_t vehicle) const
+{
+  return m_current[vehicle];
+}
+
+int32_t
+AssociationTracker::GetPredicted (uint32_t vehicle) const
+{
+  return m_predicted[vehicle];
+}
+
+uint64_t
+AssociationTracker::GetHandoverCount (void) const
+{
+  return m_handovers;
+}
+
+uint64_t
+AssociationTracker::GetPredictedHandoverCount (void) const
+{
+  return m_predictedHandovers;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (HandoverTag);
+
+HandoverTag::HandoverTag ()
+  : m_flow (0),
+    m_seq (0)
+{
+}
+
+TypeId
+HandoverTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HandoverTag")
+    .SetParent<Tag> ()
+    .AddConstructor<HandoverTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+HandoverTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+HandoverTag::GetSerializedSize (void) const
+{
+  return 4 + 4;
+}
+
+void
+HandoverTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU32 (m_flow);
+  buf.WriteU32 (m_seq);
+}
+
+void
+HandoverTag::Deserialize (TagBuffer buf)
+{
+  m_flow = buf.ReadU32 ();
+  m_seq = buf.ReadU32 ();
+}
+
+void
+HandoverTag::Print (std::ostream &os) const
+{
+  os << "flow=" << m_flow << " seq=" << m_seq;
+}
+
+void
+HandoverTag::SetFlow (uint32_t flow)
+{
+  m_flow = flow;
+}
+
+uint32_t
+HandoverTag::GetFlow (void) const
+{
+  return m_flow;
+}
+
+void
+HandoverTag::SetSeq (uint32_t seq)
+{
+  m_seq = seq;
+}
+
+uint32_t
+HandoverTag::GetSeq (void) const
+{
+  return m_seq;
+}
+
+HandoverMonitor::HandoverMonitor ()
+{
+}
+
+void
+HandoverMonitor::AddServer (Ptr<Node> server, Ipv4Address address)
+{
+  m_serverAddresses.push_back (address);
+  Ptr<Ipv4L3Protocol> ipv4 = server->GetObject<Ipv4L3Protocol> ();
+  ipv4->TraceConnectWithoutContext ("SendOutgoing", MakeBoundCallback (&HandoverMonitor::ServerSend, this));
+  ipv4->TraceConnectWithoutContext ("LocalDeliver", MakeBoundCallback (&HandoverMonitor::Deliver, this));
+}
+
+void
+HandoverMonitor::AddVehicle (Ptr<Node> vehicle, Ipv4Address address)
+{
+  uint32_t index = m_handovers.size ();
+  m_vehicleIndex[address.Get ()] = index;
+  m_handovers.resize (index + 1);
+  m_flows.resize (2 * (index + 1));
+  Ptr<Ipv4L3Protocol> ipv4 = vehicle->GetObject<Ipv4L3Protocol> ();
+  ipv4->TraceConnectWithoutContext ("SendOutgoing", MakeBoundCallback (&HandoverMonitor::VehicleSend, this, index));
+  ipv4->TraceConnectWithoutContext ("LocalDeliver", MakeBoundCallback (&HandoverMonitor::Deliver, this));
+}
+
+void
+HandoverMonitor::NotifyHandover (uint32_t vehicle, Time time)
+{
+  m_handovers[vehicle].push_back (time.GetSeconds ());
+}
+
+void
+HandoverMonitor::Send (uint32_t flow, Ptr<const Packet> packet)
+{
+  Flow &f = m_flows[flow];
+  HandoverTag tag;
+  tag.SetFlow (flow);
+  tag.SetSeq (f.txTimes.size ());
+  packet->AddPacketTag (tag);
+  f.txTimes.push_back (Simulator::Now ().GetSeconds ());
+  f.rxTimes.push_back (-1.0);
+}
+
+void
+HandoverMonitor::Receive (Ptr<const Packet> packet)
+{
+  HandoverTag tag;
+  if (!packet->PeekPacketTag (tag) || tag.GetFlow () >= m_flows.size ())
+    {
+      return;
+    }
+  Flow &f = m_flows[tag.GetFlow ()];
+  // Bản sao thứ hai (ví dụ khi gửi kép qua hai RSU) không tính
+  if (tag.GetSeq () >= f.rxTimes.size () || f.rxTimes[tag.GetSeq ()] >= 0)
+    {
+      return;
+    }
+  double now = Simulator::Now ().GetSeconds ();
+  f.rxTimes[tag.GetSeq ()] = now;
+  f.arrivals.push_back (now);
+  f.arrivalSeq.push_back (tag.GetSeq ());
+}
+
+void
+HandoverMonitor::ServerSend (HandoverMonitor *monitor, const Ipv4Header &header, Ptr<const Packet> packet,
+                             uint32_t interface)
+{
+  auto it = monitor->m_vehicleIndex.find (header.GetDestination ().Get ());
+  if (it != monitor->m_vehicleIndex.end ())
+    {
+      monitor->Send (2 * it->second + DOWNLINK, packet);
+    }
+}
+
+void
+HandoverMonitor::VehicleSend (HandoverMonitor *monitor, uint32_t vehicle, const Ipv4Header &header,
+                              Ptr<const Packet> packet, uint32_t interface)
+{
+  const std::vector<Ipv4Address> &servers = monitor->m_serverAddresses;
+  if (std::find (servers.begin (), servers.end (), header.GetDestination ()) != servers.end ())
+    {
+      monitor->Send (2 * vehicle + UPLINK, packet);
+    }
+}
+
+void
+HandoverMonitor::Deliver (HandoverMonitor *monitor, const Ipv4Header &header, Ptr<const Packet> packet,
+                          uint32_t interface)
+{
+  monitor->Receive (packet);
+}
+
+void
+HandoverMonitor::Report (std::ostream &os) const
+{
+  const char *names[] = { "lên", "xuống" };
+  for (uint32_t dir = UPLINK; dir <= DOWNLINK; dir++)
+    {
+      uint32_t count = 0;
+      double totalGap = 0.0;
+      double maxGap = 0.0;
+      uint64_t totalLost = 0;
+      for (uint32_t v = 0; v < m_handovers.size (); v++)
+        {
+          const Flow &f = m_flows[2 * v + dir];
+          for (double t : m_handovers[v])
+            {
+              // Gói nhận cuối cùng trước t và gói nhận đầu tiên sau t
+              std::size_t after = std::upper_bound (f.arrivals.begin (), f.arrivals.end (), t) - f.arrivals.begin ();
+              if (after == 0 || after == f.arrivals.size ())
+                {
+                  continue;  // flow chưa bắt đầu hoặc đã kết thúc
+                }
+              double gap = f.arrivals[after] - f.arrivals[after - 1];
+              uint32_t first = std::min (f.arrivalSeq[after - 1], f.arrivalSeq[after]);
+              uint32_t last = std::max (f.arrivalSeq[after - 1], f.arrivalSeq[after]);
+              for (uint32_t seq = first + 1; seq < last; seq++)
+                {
+                  totalLost += f.rxTimes[seq] < 0;
+                }
+              totalGap += gap;
+              maxGap = std::max (maxGap, gap);
+              count++;
+            }
+        }
+      os << "Handover (chiều " << names[dir] << (dir == UPLINK ? ", xấp xỉ" : "") << "): "
+         << count << " lần có lưu lượng";
+      if (count > 0)
+        {
+          os << ", gián đoạn trung bình " << totalGap / count * 1000 << " ms, max " << maxGap * 1000
+             << " ms, mất trung bình " << static_cast<double> (totalLost) / count << " gói/lần";
+        }
+      os << std::endl;
+    }
+}
+
+#endif /* HANDOVER_H */
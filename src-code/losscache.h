@@ -0,0 +1,365 @@
+#ifndef LOSSCACHE_H
+#define LOSSCACHE_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+
+// Bọc một mô hình suy hao bằng bảng tra theo khoảng cách lượng tử hóa.
+// Khoảng [MinDistance, MaxDistance) được chia thành các ô rộng Resolution mét,
+// suy hao ở hai biên ô được tính một lần khi ô được dùng lần đầu rồi nội suy
+// tuyến tính, nên mỗi lần tra chỉ tốn một phép nhân thay vì log10.
+// Khi dựng ô, sai số nội suy được kiểm tra tại ba điểm trong ô; ô vượt
+// MaxErrorDb (các ô rất gần nguồn, ô chứa điểm gãy của ThreeLogDistance) và
+// mọi khoảng cách ngoài bảng đều gọi thẳng mô hình gốc.
+// Chỉ dùng cho mô hình tất định, suy hao chỉ phụ thuộc khoảng cách và không
+// phụ thuộc công suất phát.
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+
+  void SetModel (Ptr<PropagationLossModel> model);
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  // Suy hao (dB) theo bảng và theo mô hình gốc tại khoảng cách distance
+  double GetCachedLoss (double distance) const;
+  double GetExactLoss (double distance) const;
+
+  uint32_t GetCachedBins (void) const;
+  uint32_t GetExactBins (void) const;
+  uint64_t GetTableLookups (void) const;
+  uint64_t GetExactCalls (void) const;
+
+  // So sánh bảng với mô hình gốc trên dải khoảng cách và đo số lần tính/giây
+  static void PrintAccuracyReport (Ptr<PropagationLossModel> exact, double maxErrorDb, std::ostream &os);
+
+private:
+  enum BinState
+  {
+    BIN_UNKNOWN,
+    BIN_CACHED,
+    BIN_EXACT
+  };
+
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  void Build (void) const;
+  // Trả về chỉ số ô, -1 nếu khoảng cách nằm ngoài bảng
+  int32_t GetBin (double distance) const;
+  void PrepareBin (int32_t bin) const;
+  double GetNodeLoss (int32_t node) const;
+  double Interpolate (int32_t bin, double distance) const;
+
+  Ptr<PropagationLossModel>                     m_model;
+  double                                        m_minDistance;
+  double                                        m_maxDistance;
+  double                                        m_resolution;
+  double                                        m_maxErrorDb;
+
+  // Bảng dựng dần trong DoCalcRxPower (hàm const)
+  mutable bool                                  m_built;
+  mutable double                                m_invResolution;
+  mutable std::vector<double>                   m_nodeLoss;     // suy hao tại biên ô, NaN nếu chưa tính
+  mutable std::vector<uint8_t>                  m_binState;
+  mutable Ptr<ConstantPositionMobilityModel>    m_origin;       // cặp vị trí để gọi mô hình gốc theo khoảng cách
+  mutable Ptr<ConstantPositionMobilityModel>    m_probe;
+  mutable uint32_t                              m_cachedBins;
+  mutable uint32_t                              m_exactBins;
+  mutable uint64_t                              m_lookups;
+  mutable uint64_t                              m_exactCalls;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The exact propagation loss model being cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("MinDistance",
+                   "Distances below this are always computed exactly (m).",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_minDistance),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("MaxDistance",
+                   "Distances at or above this are always computed exactly (m).",
+                   DoubleValue (2000.0),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_maxDistance),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("Resolution",
+                   "Width of a distance bin (m).",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_resolution),
+                   MakeDoubleChecker<double> (1e-6))
+    .AddAttribute ("MaxErrorDb",
+                   "Bins whose interpolation error exceeds this fall back to the exact model (dB).",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_maxErrorDb),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_model (0),
+    m_minDistance (1.0),
+    m_maxDistance (2000.0),
+    m_resolution (0.1),
+    m_maxErrorDb (0.01),
+    m_built (false),
+    m_invResolution (0.0),
+    m_origin (0),
+    m_probe (0),
+    m_cachedBins (0),
+    m_exactBins (0),
+    m_lookups (0),
+    m_exactCalls (0)
+{
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  m_model = model;
+  m_built = false;
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+double
+CachedPropagationLossModel::GetCachedLoss (double distance) const
+{
+  int32_t bin = GetBin (distance);
+  if (bin < 0)
+    {
+      return GetExactLoss (distance);
+    }
+  PrepareBin (bin);
+  return m_binState[bin] == BIN_CACHED ? Interpolate (bin, distance) : GetExactLoss (distance);
+}
+
+double
+CachedPropagationLossModel::GetExactLoss (double distance) const
+{
+  Build ();
+  m_probe->SetPosition (Vector (distance, 0, 0));
+  return -m_model->CalcRxPower (0.0, m_origin, m_probe);
+}
+
+uint32_t
+CachedPropagationLossModel::GetCachedBins (void) const
+{
+  return m_cachedBins;
+}
+
+uint32_t
+CachedPropagationLossModel::GetExactBins (void) const
+{
+  return m_exactBins;
+}
+
+uint64_t
+CachedPropagationLossModel::GetTableLookups (void) const
+{
+  return m_lookups;
+}
+
+uint64_t
+CachedPropagationLossModel::GetExactCalls (void) const
+{
+  return m_exactCalls;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  double distance = a->GetDistanceFrom (b);
+  int32_t bin = GetBin (distance);
+  if (bin >= 0)
+    {
+      PrepareBin (bin);
+      if (m_binState[bin] == BIN_CACHED)
+        {
+          m_lookups++;
+          return txPowerDbm - Interpolate (bin, distance);
+        }
+    }
+  m_exactCalls++;
+  return m_model->CalcRxPower (txPowerDbm, a, b);
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return m_model ? m_model->AssignStreams (stream) : 0;
+}
+
+void
+CachedPropagationLossModel::Build (void) const
+{
+  if (m_built)
+    {
+      return;
+    }
+  NS_ABORT_MSG_UNLESS (m_model, "CachedPropagationLossModel needs a Model");
+  NS_ABORT_MSG_IF (m_maxDistance <= m_minDistance, "MaxDistance must be larger than MinDistance");
+
+  m_invResolution = 1.0 / m_resolution;
+  uint32_t bins = static_cast<uint32_t> (std::ceil ((m_maxDistance - m_minDistance) * m_invResolution));
+  m_nodeLoss.assign (bins + 1, std::numeric_limits<double>::quiet_NaN ());
+  m_binState.assign (bins, BIN_UNKNOWN);
+  m_cachedBins = 0;
+  m_exactBins = 0;
+  if (!m_origin)
+    {
+      m_origin = CreateObject<ConstantPositionMobilityModel> ();
+      m_probe = CreateObject<ConstantPositionMobilityModel> ();
+    }
+  m_origin->SetPosition (Vector (0, 0, 0));
+  m_built = true;
+}
+
+int32_t
+CachedPropagationLossModel::GetBin (double distance) const
+{
+  Build ();
+  if (distance < m_minDistance || distance >= m_maxDistance)
+    {
+      return -1;
+    }
+  int32_t bin = static_cast<int32_t> ((distance - m_minDistance) * m_invResolution);
+  return std::min (bin, static_cast<int32_t> (m_binState.size ()) - 1);
+}
+
+void
+CachedPropagationLossModel::PrepareBin (int32_t bin) const
+{
+  if (m_binState[bin] != BIN_UNKNOWN)
+    {
+      return;
+    }
+
+  // Kiểm tra nội suy tại 1/4, 1/2, 3/4 ô
+  double maxError = 0.0;
+  for (double t : {0.25, 0.5, 0.75})
+    {
+      double distance = m_minDistance + (bin + t) * m_resolution;
+      double expected = (1 - t) * GetNodeLoss (bin) + t * GetNodeLoss (bin + 1);
+      maxError = std::max (maxError, std::fabs (expected - GetExactLoss (distance)));
+    }
+
+  if (maxError <= m_maxErrorDb)
+    {
+      m_binState[bin] = BIN_CACHED;
+      m_cachedBins++;
+    }
+  else
+    {
+      m_binState[bin] = BIN_EXACT;
+      m_exactBins++;
+    }
+}
+
+double
+CachedPropagationLossModel::GetNodeLoss (int32_t node) const
+{
+  if (std::isnan (m_nodeLoss[node]))
+    {
+      m_nodeLoss[node] = GetExactLoss (m_minDistance + node * m_resolution);
+    }
+  return m_nodeLoss[node];
+}
+
+double
+CachedPropagationLossModel::Interpolate (int32_t bin, double distance) const
+{
+  double t = (distance - m_minDistance) * m_invResolution - bin;
+  return m_nodeLoss[bin] + t * (m_nodeLoss[bin + 1] - m_nodeLoss[bin]);
+}
+
+void
+CachedPropagationLossModel::PrintAccuracyReport (Ptr<PropagationLossModel> exact, double maxErrorDb, std::ostream &os)
+{
+  Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+  cache->SetModel (exact);
+  cache->SetAttribute ("MaxErrorDb", DoubleValue (maxErrorDb));
+
+  // Quét khoảng cách theo dãy Weyl (phủ đều, không trùng biên ô)
+  const uint32_t samples = 200000;
+  const double golden = 0.6180339887498949;
+  double minDistance = cache->m_minDistance;
+  double maxDistance = cache->m_maxDistance;
+  std::vector<double> distances (samples);
+  for (uint32_t i = 0; i < samples; i++)
+    {
+      double frac = std::fmod (i * golden, 1.0);
+      distances[i] = minDistance + frac * (maxDistance - minDistance);
+    }
+
+  double maxError = 0.0;
+  double sumError = 0.0;
+  double worstDistance = 0.0;
+  for (double d : distances)
+    {
+      double error = std::fabs (cache->GetCachedLoss (d) - cache->GetExactLoss (d));
+      sumError += error;
+      if (error > maxError)
+        {
+          maxError = error;
+          worstDistance = d;
+        }
+    }
+
+  // Số lần tính công suất nhận mỗi giây qua CalcRxPower, như kênh Wi-Fi gọi
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  double rates[2];
+  Ptr<PropagationLossModel> models[2] = {exact, cache};
+  for (uint32_t m = 0; m < 2; m++)
+    {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      for (double d : distances)
+        {
+          b->SetPosition (Vector (d, 0, 0));
+          models[m]->CalcRxPower (16.0, a, b);
+        }
+      double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+      rates[m] = seconds > 0 ? samples / seconds : 0.0;
+    }
+
+  os << "Bảng suy hao [" << minDistance << ", " << maxDistance << ") m, "
+     << cache->GetCachedBins () << " ô nội suy, " << cache->GetExactBins () << " ô tính trực tiếp" << std::endl;
+  os << "Sai số: lớn nhất " << maxError << " dB (tại " << worstDistance << " m), trung bình "
+     << sumError / samples << " dB, giới hạn " << maxErrorDb << " dB" << std::endl;
+  os << "Thông lượng CalcRxPower: gốc " << rates[0] << " lần/giây, bảng " << rates[1]
+     << " lần/giây (x" << (rates[0] > 0 ? rates[1] / rates[0] : 0.0) << ")" << std::endl;
+}
+
+#endif /* LOSSCACHE_H */
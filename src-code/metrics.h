@@ -0,0 +1,767 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "probe.h"
+#include "flowtracewriter.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+
+// Các phân vị của một phân bố độ trễ (s)
+struct Percentiles
+{
+  Percentiles ();
+
+  double p50;
+  double p95;
+  double p99;
+  double max;   // cận trên của bin cao nhất có gói tin
+};
+
+// Ghi theo thứ tự cột CSV: p50,p95,p99,max
+std::ostream &operator<< (std::ostream &os, const Percentiles &p);
+
+// Histogram gộp từ histogram của nhiều flow (cùng độ rộng bin).
+// Chỉ lưu số đếm theo bin nên tính phân vị mất O(số bin), không cần
+// giữ lại từng mẫu độ trễ.
+class MergedHistogram
+{
+public:
+  MergedHistogram ();
+
+  void SetBinWidth (double width);
+  void Add (uint32_t bin, int64_t count);
+  void Clear (void);
+  uint64_t GetCount (void) const;
+  Percentiles GetPercentiles (void) const;
+
+private:
+  double                 m_binWidth;
+  std::vector<uint64_t>  m_bins;
+  uint64_t               m_count;
+};
+
+// Lớp lưu lượng, xác định theo cổng đích của flow
+struct TrafficClass
+{
+  std::string      name;
+  uint16_t         port;
+  MergedHistogram  delay;
+  MergedHistogram  jitter;
+};
+
+// Trạng thái được giữ lại của một flow giữa hai lần lấy mẫu
+struct FlowEntry
+{
+  FlowEntry ();
+
+  bool                          known;       // five-tuple đã được tra cứu
+  Ipv4FlowClassifier::FiveTuple tuple;
+  uint32_t                      txPackets;   // bộ đếm tại lần lấy mẫu trước
+  uint32_t                      rxPackets;
+  uint64_t                      rxBytes;
+  Time                          delaySum;
+  std::vector<uint32_t>         delayBins;   // histogram độ trễ tại lần lấy mẫu trước
+  std::vector<uint32_t>         jitterBins;
+  int32_t                       trafficClass; // -1 nếu không thuộc lớp nào
+  bool                          valid;       // đang được cộng vào giá trị trung bình
+  double                        throughput;  // Kbps
+  double                        avgDelay;    // s
+  double                        pdr;         // %
+};
+
+// Bộ máy tính thông số dùng chung cho các kịch bản.
+// Mỗi lần lấy mẫu chỉ cập nhật các flow có bộ đếm thay đổi; tổng của các
+// giá trị trung bình được cộng/trừ dần nên không phải duyệt lại mọi flow.
+// Chế độ INTERVAL tính giá trị trong cửa sổ từ hiệu của bộ đếm hiện tại và
+// ảnh chụp ở lần lấy mẫu trước, không lưu lịch sử từng lần lấy mẫu.
+// Histogram delay/jitter của FlowMonitor cũng được gộp theo hiệu số bin
+// để tính p50/p95/p99 cho toàn mạng và cho từng lớp lưu lượng.
+class MetricsEngine
+{
+public:
+
+  enum Mode
+  {
+    CUMULATIVE,   // cộng dồn từ gói tin đầu tiên (như trước đây)
+    INTERVAL      // giá trị riêng của từng cửa sổ lấy mẫu
+  };
+
+  MetricsEngine ();
+
+  void Setup (Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier);
+  void Setup (ProbeRegistry *probes);
+  // Ghi bộ đếm của mọi flow thay đổi ở mỗi lần lấy mẫu vào chuỗi thời gian nhị phân
+  void SetTrace (FlowTraceWriter *trace);
+  void SetMode (Mode mode);
+  void SetMode (const std::string &mode);
+  Mode GetMode (void) const;
+  void SetWindow (Time window);
+  Time GetWindow (void) const;
+  void AddTrafficClass (const std::string &name, uint16_t port);
+  void Sample (void);
+
+  uint32_t GetFlowCount (void) const;
+  uint32_t GetValidFlowCount (void) const;
+  double GetAvgThroughput (void) const;
+  double GetAvgDelay (void) const;
+  double GetAvgPdr (void) const;
+  Percentiles GetDelayPercentiles (void) const;
+  Percentiles GetJitterPercentiles (void) const;
+  // Tính trên tổng gói của toàn mạng trong cửa sổ vừa lấy mẫu, ở cả hai chế độ
+  uint64_t GetWindowTxPackets (void) const;
+  double GetWindowPdr (void) const;
+  double GetWindowDelay (void) const;
+  // Độ trễ thiết lập của từng flow: từ gói gửi đầu tiên tới gói nhận đầu tiên,
+  // gồm cả thời gian tìm đường / cài luật trước khi flow đi được
+  void PrintSetupLatency (std::ostream &os, bool perFlow) const;
+
+  uint32_t GetTrafficClassCount (void) const;
+  const std::string &GetTrafficClassName (uint32_t cls) const;
+  Percentiles GetClassDelayPercentiles (uint32_t cls) const;
+  Percentiles GetClassJitterPercentiles (uint32_t cls) const;
+
+  FlowId GetMaxFlowId (void) const;
+  const FlowEntry &GetFlow (FlowId id) const;
+  const std::vector<FlowId> &GetChangedFlows (void) const;
+
+private:
+  void SampleFlow (FlowId id, const FlowMonitor::FlowStats &st);
+  void UpdateFlow (FlowId id, const FlowMonitor::FlowStats &st);
+  void UpdateCumulative (FlowEntry &entry, const FlowMonitor::FlowStats &st);
+  void UpdateInterval (FlowEntry &entry, const FlowMonitor::FlowStats &st);
+  void UpdateHistogram (std::vector<uint32_t> &snapshot, const Histogram &current,
+                        MergedHistogram &merged, MergedHistogram *classMerged);
+
+  Ptr<FlowMonitor>         m_monitor;
+  Ptr<Ipv4FlowClassifier>  m_classifier;
+  ProbeRegistry           *m_probes;      // nguồn thay cho FlowMonitor khi đo ở tầng ứng dụng
+  FlowTraceWriter         *m_trace;
+  Mode                     m_mode;
+  Time                     m_window;
+  Time                     m_lastSample;
+  double                   m_elapsed;     // độ dài cửa sổ thực tế (s)
+  std::vector<FlowEntry>   m_flows;       // đánh chỉ số theo FlowId
+  std::vector<FlowId>      m_changed;     // các flow thay đổi ở lần lấy mẫu gần nhất
+  std::vector<TrafficClass> m_classes;
+  MergedHistogram          m_delayHist;   // gộp theo cửa sổ (INTERVAL) hoặc cộng dồn
+  MergedHistogram          m_jitterHist;
+  uint32_t                 m_flowCount;
+  uint32_t                 m_validCount;
+  uint32_t                 m_delayCount;  // số flow có gói nhận trong cửa sổ
+  uint32_t                 m_pdrCount;    // số flow có gói gửi trong cửa sổ
+  double                   m_totalThroughput;
+  double                   m_totalDelay;
+  double                   m_totalPdr;
+  uint64_t                 m_windowTx;    // tổng số gói gửi / nhận trong cửa sổ
+  uint64_t                 m_windowRx;
+  Time                     m_windowDelay; // tổng độ trễ của các gói nhận trong cửa sổ
+};
+
+Percentiles::Percentiles ()
+  : p50 (0.0),
+    p95 (0.0),
+    p99 (0.0),
+    max (0.0)
+{
+}
+
+std::ostream &
+operator<< (std::ostream &os, const Percentiles &p)
+{
+  os << p.p50 << "," << p.p95 << "," << p.p99 << "," << p.max;
+  return os;
+}
+
+MergedHistogram::MergedHistogram ()
+  : m_binWidth (0.001),
+    m_count (0)
+{
+}
+
+void
+MergedHistogram::SetBinWidth (double width)
+{
+  m_binWidth = width;
+}
+
+void
+MergedHistogram::Add (uint32_t bin, int64_t count)
+{
+  if (bin >= m_bins.size ())
+    {
+      m_bins.resize (bin + 1, 0);
+    }
+  m_bins[bin] += count;
+  m_count += count;
+}
+
+void
+MergedHistogram::Clear (void)
+{
+  std::fill (m_bins.begin (), m_bins.end (), 0);
+  m_count = 0;
+}
+
+uint64_t
+MergedHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+Percentiles
+MergedHistogram::GetPercentiles (void) const
+{
+  Percentiles result;
+  if (m_count == 0)
+    {
+      return result;
+    }
+
+  // Một lần duyệt qua các bin, nội suy tuyến tính bên trong bin chứa phân vị
+  const double quantiles[3] = {0.50, 0.95, 0.99};
+  double *outputs[3] = {&result.p50, &result.p95, &result.p99};
+  uint32_t next = 0;
+  uint64_t below = 0;
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      uint64_t count = m_bins[i];
+      if (count == 0)
+        {
+          continue;
+        }
+      while (next < 3 && below + count >= quantiles[next] * m_count)
+        {
+          double fraction = (quantiles[next] * m_count - below) / count;
+          *outputs[next] = (i + fraction) * m_binWidth;
+          next++;
+        }
+      below += count;
+      result.max = (i + 1) * m_binWidth;
+    }
+  return result;
+}
+
+FlowEntry::FlowEntry ()
+  : known (false),
+    tuple (),
+    txPackets (0),
+    rxPackets (0),
+    rxBytes (0),
+    delaySum (),
+    trafficClass (-1),
+    valid (false),
+    throughput (0.0),
+    avgDelay (0.0),
+    pdr (0.0)
+{
+}
+
+MetricsEngine::MetricsEngine ()
+  : m_monitor (0),
+    m_classifier (0),
+    m_probes (0),
+    m_trace (0),
+    m_mode (CUMULATIVE),
+    m_window (Seconds (1.0)),
+    m_lastSample (),
+    m_elapsed (0.0),
+    m_flowCount (0),
+    m_validCount (0),
+    m_delayCount (0),
+    m_pdrCount (0),
+    m_totalThroughput (0.0),
+    m_totalDelay (0.0),
+    m_totalPdr (0.0),
+    m_windowTx (0),
+    m_windowRx (0)
+{
+}
+
+void
+MetricsEngine::Setup (Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier)
+{
+  m_monitor = monitor;
+  m_classifier = classifier;
+}
+
+void
+MetricsEngine::Setup (ProbeRegistry *probes)
+{
+  m_probes = probes;
+}
+
+void
+MetricsEngine::SetTrace (FlowTraceWriter *trace)
+{
+  m_trace = trace;
+}
+
+void
+MetricsEngine::SetMode (Mode mode)
+{
+  m_mode = mode;
+}
+
+void
+MetricsEngine::SetMode (const std::string &mode)
+{
+  if (mode == "interval")
+    {
+      m_mode = INTERVAL;
+    }
+  else if (mode == "cumulative")
+    {
+      m_mode = CUMULATIVE;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown metrics mode: " << mode);
+    }
+}
+
+MetricsEngine::Mode
+MetricsEngine::GetMode (void) const
+{
+  return m_mode;
+}
+
+void
+MetricsEngine::SetWindow (Time window)
+{
+  NS_ABORT_MSG_IF (!window.IsStrictlyPositive (), "Metrics window must be positive");
+  m_window = window;
+}
+
+Time
+MetricsEngine::GetWindow (void) const
+{
+  return m_window;
+}
+
+void
+MetricsEngine::AddTrafficClass (const std::string &name, uint16_t port)
+{
+  TrafficClass cls;
+  cls.name = name;
+  cls.port = port;
+  m_classes.push_back (cls);
+}
+
+void
+MetricsEngine::Sample (void)
+{
+  m_elapsed = (Simulator::Now () - m_lastSample).GetSeconds ();
+  m_lastSample = Simulator::Now ();
+  if (m_mode == INTERVAL)
+    {
+      // Cửa sổ mới: flow nào không đổi thì không đóng góp vào cửa sổ này
+      for (FlowId id : m_changed)
+        {
+          m_flows[id].valid = false;
+        }
+      m_validCount = 0;
+      m_delayCount = 0;
+      m_pdrCount = 0;
+      m_totalThroughput = 0.0;
+      m_totalDelay = 0.0;
+      m_totalPdr = 0.0;
+      m_delayHist.Clear ();
+      m_jitterHist.Clear ();
+      for (TrafficClass &cls : m_classes)
+        {
+          cls.delay.Clear ();
+          cls.jitter.Clear ();
+        }
+    }
+  m_changed.clear ();
+  m_windowTx = 0;
+  m_windowRx = 0;
+  m_windowDelay = Time (0);
+
+  if (m_probes)
+    {
+      // Bộ đếm tầng ứng dụng đã nằm trong mảng phẳng theo FlowId
+      const std::vector<FlowMonitor::FlowStats> &stats = m_probes->GetFlowStats ();
+      m_flowCount = 0;
+      for (FlowId id = 1; id < stats.size (); id++)
+        {
+          // Như FlowMonitor, flow chỉ xuất hiện sau gói tin đầu tiên
+          if (stats[id].txPackets > 0)
+            {
+              m_flowCount++;
+              SampleFlow (id, stats[id]);
+            }
+        }
+      return;
+    }
+  if (!m_monitor)
+    {
+      return;
+    }
+
+  // Đọc trực tiếp qua tham chiếu, không sao chép map của FlowMonitor.
+  // FlowMonitor không báo flow nào thay đổi nên vẫn phải so sánh bộ đếm,
+  // nhưng mọi phép tính chỉ thực hiện trên các flow đã thay đổi.
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  m_flowCount = stats.size ();
+  for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); ++i)
+    {
+      SampleFlow (i->first, i->second);
+    }
+}
+
+void
+MetricsEngine::SampleFlow (FlowId id, const FlowMonitor::FlowStats &st)
+{
+  if (id >= m_flows.size ())
+    {
+      m_flows.resize (id + 1);
+    }
+  const FlowEntry &entry = m_flows[id];
+  if (!entry.known
+      || entry.txPackets != st.txPackets
+      || entry.rxPackets != st.rxPackets)
+    {
+      UpdateFlow (id, st);
+    }
+}
+
+void
+MetricsEngine::UpdateFlow (FlowId id, const FlowMonitor::FlowStats &st)
+{
+  FlowEntry &entry = m_flows[id];
+  if (!entry.known)
+    {
+      // FindFlow duyệt tuyến tính nên chỉ gọi một lần cho mỗi flow
+      entry.tuple = m_probes ? m_probes->GetTuple (id) : m_classifier->FindFlow (id);
+      entry.known = true;
+      for (uint32_t c = 0; c < m_classes.size (); c++)
+        {
+          if (m_classes[c].port == entry.tuple.destinationPort)
+            {
+              entry.trafficClass = c;
+              break;
+            }
+        }
+    }
+
+  // Histogram chỉ đổi khi có gói nhận, tức là khi flow nằm trong m_changed
+  MergedHistogram *classDelay = entry.trafficClass >= 0 ? &m_classes[entry.trafficClass].delay : 0;
+  MergedHistogram *classJitter = entry.trafficClass >= 0 ? &m_classes[entry.trafficClass].jitter : 0;
+  UpdateHistogram (entry.delayBins, st.delayHistogram, m_delayHist, classDelay);
+  UpdateHistogram (entry.jitterBins, st.jitterHistogram, m_jitterHist, classJitter);
+
+  if (m_mode == INTERVAL)
+    {
+      UpdateInterval (entry, st);
+    }
+  else
+    {
+      UpdateCumulative (entry, st);
+    }
+
+  if (m_trace)
+    {
+      m_trace->Add (id, entry.tuple, st);
+    }
+
+  m_windowTx += st.txPackets - entry.txPackets;
+  m_windowRx += st.rxPackets - entry.rxPackets;
+  m_windowDelay += st.delaySum - entry.delaySum;
+
+  // Ảnh chụp bộ đếm cho lần lấy mẫu sau
+  entry.txPackets = st.txPackets;
+  entry.rxPackets = st.rxPackets;
+  entry.rxBytes = st.rxBytes;
+  entry.delaySum = st.delaySum;
+
+  m_changed.push_back (id);
+}
+
+void
+MetricsEngine::UpdateCumulative (FlowEntry &entry, const FlowMonitor::FlowStats &st)
+{
+  if (entry.valid)
+    {
+      m_totalThroughput -= entry.throughput;
+      m_totalDelay -= entry.avgDelay;
+      m_totalPdr -= entry.pdr;
+      m_validCount--;
+    }
+
+  entry.valid = false;
+  if (st.txPackets > 0 && st.rxPackets > 0)
+    {
+      double duration = st.timeLastRxPacket.GetSeconds () - st.timeFirstTxPacket.GetSeconds ();
+      if (duration > 0)
+        {
+          entry.throughput = st.rxBytes * 8.0 / duration / 1024; // Kbps
+          entry.avgDelay = st.delaySum.GetSeconds () / st.rxPackets;
+          entry.pdr = (st.rxPackets * 100.0) / st.txPackets;
+          entry.valid = true;
+
+          m_totalThroughput += entry.throughput;
+          m_totalDelay += entry.avgDelay;
+          m_totalPdr += entry.pdr;
+          m_validCount++;
+        }
+    }
+
+  if (m_validCount == 0)
+    {
+      // Tránh sai số dồn tích khi không còn flow hợp lệ
+      m_totalThroughput = 0.0;
+      m_totalDelay = 0.0;
+      m_totalPdr = 0.0;
+    }
+}
+
+void
+MetricsEngine::UpdateInterval (FlowEntry &entry, const FlowMonitor::FlowStats &st)
+{
+  uint32_t txDelta = st.txPackets - entry.txPackets;
+  uint32_t rxDelta = st.rxPackets - entry.rxPackets;
+  uint64_t rxBytesDelta = st.rxBytes - entry.rxBytes;
+
+  entry.valid = (txDelta > 0 || rxDelta > 0) && m_elapsed > 0;
+  if (!entry.valid)
+    {
+      return;
+    }
+
+  entry.throughput = rxBytesDelta * 8.0 / m_elapsed / 1024; // Kbps
+  m_totalThroughput += entry.throughput;
+  m_validCount++;
+
+  entry.avgDelay = 0.0;
+  if (rxDelta > 0)
+    {
+      entry.avgDelay = (st.delaySum - entry.delaySum).GetSeconds () / rxDelta;
+      m_totalDelay += entry.avgDelay;
+      m_delayCount++;
+    }
+
+  // Gói gửi ở cuối cửa sổ trước có thể được nhận trong cửa sổ này nên
+  // PDR của một cửa sổ được giới hạn ở 100%
+  entry.pdr = 0.0;
+  if (txDelta > 0)
+    {
+      entry.pdr = std::min (100.0, (rxDelta * 100.0) / txDelta);
+      m_totalPdr += entry.pdr;
+      m_pdrCount++;
+    }
+}
+
+void
+MetricsEngine::UpdateHistogram (std::vector<uint32_t> &snapshot, const Histogram &current,
+                                MergedHistogram &merged, MergedHistogram *classMerged)
+{
+  uint32_t nBins = current.GetNBins ();
+  if (nBins == 0)
+    {
+      return;
+    }
+  if (snapshot.size () < nBins)
+    {
+      snapshot.resize (nBins, 0);
+    }
+  merged.SetBinWidth (current.GetBinWidth (0));
+  if (classMerged)
+    {
+      classMerged->SetBinWidth (current.GetBinWidth (0));
+    }
+
+  // Chỉ cộng phần chênh lệch so với lần lấy mẫu trước
+  for (uint32_t i = 0; i < nBins; i++)
+    {
+      uint32_t count = current.GetBinCount (i);
+      if (count != snapshot[i])
+        {
+          int64_t delta = static_cast<int64_t> (count) - snapshot[i];
+          merged.Add (i, delta);
+          if (classMerged)
+            {
+              classMerged->Add (i, delta);
+            }
+          snapshot[i] = count;
+        }
+    }
+}
+
+uint32_t
+MetricsEngine::GetFlowCount (void) const
+{
+  return m_flowCount;
+}
+
+uint32_t
+MetricsEngine::GetValidFlowCount (void) const
+{
+  return m_validCount;
+}
+
+double
+MetricsEngine::GetAvgThroughput (void) const
+{
+  return m_validCount > 0 ? m_totalThroughput / m_validCount : 0.0;
+}
+
+double
+MetricsEngine::GetAvgDelay (void) const
+{
+  uint32_t count = m_mode == INTERVAL ? m_delayCount : m_validCount;
+  return count > 0 ? m_totalDelay / count : 0.0;
+}
+
+double
+MetricsEngine::GetAvgPdr (void) const
+{
+  uint32_t count = m_mode == INTERVAL ? m_pdrCount : m_validCount;
+  return count > 0 ? m_totalPdr / count : 0.0;
+}
+
+uint64_t
+MetricsEngine::GetWindowTxPackets (void) const
+{
+  return m_windowTx;
+}
+
+double
+MetricsEngine::GetWindowPdr (void) const
+{
+  return m_windowTx > 0 ? 100.0 * m_windowRx / m_windowTx : 0.0;
+}
+
+double
+MetricsEngine::GetWindowDelay (void) const
+{
+  return m_windowRx > 0 ? m_windowDelay.GetSeconds () / m_windowRx : 0.0;
+}
+
+void
+MetricsEngine::PrintSetupLatency (std::ostream &os, bool perFlow) const
+{
+  std::vector<std::pair<FlowId, const FlowMonitor::FlowStats *> > flows;
+  if (m_probes)
+    {
+      const std::vector<FlowMonitor::FlowStats> &stats = m_probes->GetFlowStats ();
+      for (FlowId id = 1; id < stats.size (); id++)
+        {
+          if (stats[id].txPackets > 0)
+            {
+              flows.push_back (std::make_pair (id, &stats[id]));
+            }
+        }
+    }
+  else if (m_monitor)
+    {
+      const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+      for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); ++i)
+        {
+          flows.push_back (std::make_pair (i->first, &i->second));
+        }
+    }
+
+  std::vector<double> latencies;
+  for (const auto &flow : flows)
+    {
+      const FlowMonitor::FlowStats &st = *flow.second;
+      double latency = st.rxPackets > 0 ? (st.timeFirstRxPacket - st.timeFirstTxPacket).GetSeconds () : -1.0;
+      if (latency >= 0)
+        {
+          latencies.push_back (latency);
+        }
+      if (perFlow && flow.first < m_flows.size () && m_flows[flow.first].known)
+        {
+          const FlowEntry &f = m_flows[flow.first];
+          os << "Flow " << flow.first << " (" << f.tuple.sourceAddress << " -> " << f.tuple.destinationAddress
+             << "): thiết lập ";
+          if (latency >= 0)
+            {
+              os << latency * 1000 << " ms" << std::endl;
+            }
+          else
+            {
+              os << "không thành công" << std::endl;
+            }
+        }
+    }
+  os << "Độ trễ thiết lập flow: " << latencies.size () << "/" << flows.size () << " flow";
+  if (!latencies.empty ())
+    {
+      std::sort (latencies.begin (), latencies.end ());
+      double sum = 0.0;
+      for (double l : latencies)
+        {
+          sum += l;
+        }
+      std::size_t p95 = std::min (latencies.size () - 1, static_cast<std::size_t> (0.95 * latencies.size ()));
+      os << ", trung bình " << sum / latencies.size () * 1000 << " ms, p95 " << latencies[p95] * 1000
+         << " ms, max " << latencies.back () * 1000 << " ms";
+    }
+  os << std::endl;
+}
+
+Percentiles
+MetricsEngine::GetDelayPercentiles (void) const
+{
+  return m_delayHist.GetPercentiles ();
+}
+
+Percentiles
+MetricsEngine::GetJitterPercentiles (void) const
+{
+  return m_jitterHist.GetPercentiles ();
+}
+
+uint32_t
+MetricsEngine::GetTrafficClassCount (void) const
+{
+  return m_classes.size ();
+}
+
+const std::string &
+MetricsEngine::GetTrafficClassName (uint32_t cls) const
+{
+  return m_classes[cls].name;
+}
+
+Percentiles
+MetricsEngine::GetClassDelayPercentiles (uint32_t cls) const
+{
+  return m_classes[cls].delay.GetPercentiles ();
+}
+
+Percentiles
+MetricsEngine::GetClassJitterPercentiles (uint32_t cls) const
+{
+  return m_classes[cls].jitter.GetPercentiles ();
+}
+
+FlowId
+MetricsEngine::GetMaxFlowId (void) const
+{
+  return m_flows.empty () ? 0 : m_flows.size () - 1;
+}
+
+const FlowEntry &
+MetricsEngine::GetFlow (FlowId id) const
+{
+  return m_flows[id];
+}
+
+const std::vector<FlowId> &
+MetricsEngine::GetChangedFlows (void) const
+{
+  return m_changed;
+}
+
+#endif /* METRICS_H */
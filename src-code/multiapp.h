@@ -0,0 +1,274 @@
+#ifndef MULTIAPP_H
+#define MULTIAPP_H
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "probe.h"
+
+#include <vector>
+
+using namespace ns3;
+
+
+// Một ứng dụng cho mỗi xe gửi tới nhiều đích qua một socket và một timer,
+// thay cho một MyApp + một socket cho từng cặp xe.
+// Lưu lượng của mỗi cặp giữ nguyên: mỗi đích nhận nPackets gói với dataRate,
+// bắt đầu ở thời điểm riêng của cặp (gói đầu tiên đi ngay lúc đó như MyApp)
+// rồi vào vòng gửi chung. Dùng lại gói tin mẫu theo MyApp::SetPacketReuse.
+class MultiDestApp : public Application
+{
+public:
+
+  enum Mode
+  {
+    ROUND_ROBIN,  // mỗi lần chỉ gửi tới một đích, khoảng cách gói chia cho số đích
+    FANOUT        // mỗi lần gửi tới tất cả các đích
+  };
+
+  MultiDestApp ();
+  virtual ~MultiDestApp();
+
+  void Setup (Ptr<Socket> socket, uint32_t packetSize, uint32_t nPackets, DataRate dataRate, Mode mode);
+  // start tính từ lúc ứng dụng bắt đầu; probeId khác 0 thì gói tin gửi tới
+  // đích này mang ProbeHeader
+  void AddDestination (Address address, Time start, FlowId probeId = 0);
+  void SetProbeRegistry (ProbeRegistry *registry);
+  uint32_t GetNDestinations (void) const;
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  // Đích tới thời điểm bắt đầu: gửi gói đầu tiên rồi vào vòng gửi
+  void Activate (uint32_t index);
+  void ScheduleTx (void);
+  void SendPacket (void);
+  void SendToDestination (uint32_t index);
+
+  struct Destination
+  {
+    Address  address;
+    Time     start;
+    FlowId   probeId;
+    uint32_t packetsSent;
+  };
+
+  Ptr<Socket>               m_socket;
+  std::vector<Destination>  m_destinations;
+  uint32_t                  m_packetSize;
+  uint32_t                  m_nPackets;
+  DataRate                  m_dataRate;
+  Mode                      m_mode;
+  Time                      m_pairInterval;  // khoảng cách gói của một cặp như MyApp
+  EventId                   m_sendEvent;
+  std::vector<EventId>      m_startEvents;
+  bool                      m_running;
+  std::vector<uint32_t>     m_active;      // đích đã bắt đầu và chưa gửi đủ gói
+  uint32_t                  m_next;        // vị trí kế tiếp trong m_active ở chế độ ROUND_ROBIN
+  Ptr<Packet>               m_template;
+  ProbeRegistry            *m_registry;
+};
+
+MultiDestApp::MultiDestApp ()
+  : m_socket (0),
+    m_packetSize (0),
+    m_nPackets (0),
+    m_dataRate (0),
+    m_mode (ROUND_ROBIN),
+    m_pairInterval (),
+    m_sendEvent (),
+    m_running (false),
+    m_next (0),
+    m_template (0),
+    m_registry (0)
+{
+}
+
+MultiDestApp::~MultiDestApp()
+{
+  m_socket = 0;
+}
+
+void
+MultiDestApp::Setup (Ptr<Socket> socket, uint32_t packetSize, uint32_t nPackets, DataRate dataRate, Mode mode)
+{
+  m_socket = socket;
+  m_packetSize = packetSize;
+  m_nPackets = nPackets;
+  m_dataRate = dataRate;
+  m_mode = mode;
+}
+
+void
+MultiDestApp::AddDestination (Address address, Time start, FlowId probeId)
+{
+  Destination dest;
+  dest.address = address;
+  dest.start = start;
+  dest.probeId = probeId;
+  dest.packetsSent = 0;
+  m_destinations.push_back (dest);
+}
+
+void
+MultiDestApp::SetProbeRegistry (ProbeRegistry *registry)
+{
+  m_registry = registry;
+}
+
+uint32_t
+MultiDestApp::GetNDestinations (void) const
+{
+  return m_destinations.size ();
+}
+
+void
+MultiDestApp::StartApplication (void)
+{
+  if (m_destinations.empty ())
+    {
+      return;
+    }
+  m_running = true;
+  m_active.clear ();
+  m_next = 0;
+  for (Destination &dest : m_destinations)
+    {
+      dest.packetsSent = 0;
+    }
+  m_pairInterval = Seconds (m_packetSize * 8 / static_cast<double> (m_dataRate.GetBitRate ()));
+
+  m_socket->Bind ();
+  for (uint32_t i = 0; i < m_destinations.size (); i++)
+    {
+      if (m_destinations[i].start.IsZero ())
+        {
+          Activate (i);
+        }
+      else
+        {
+          m_startEvents.push_back (Simulator::Schedule (m_destinations[i].start, &MultiDestApp::Activate, this, i));
+        }
+    }
+}
+
+void
+MultiDestApp::StopApplication (void)
+{
+  m_running = false;
+
+  if (m_sendEvent.IsRunning ())
+    {
+      Simulator::Cancel (m_sendEvent);
+    }
+  for (EventId &event : m_startEvents)
+    {
+      Simulator::Cancel (event);
+    }
+  m_startEvents.clear ();
+
+  if (m_socket)
+    {
+      m_socket->Close ();
+    }
+}
+
+void
+MultiDestApp::Activate (uint32_t index)
+{
+  SendToDestination (index);
+  if (m_destinations[index].packetsSent < m_nPackets)
+    {
+      m_active.push_back (index);
+    }
+  if (!m_sendEvent.IsRunning ())
+    {
+      ScheduleTx ();
+    }
+}
+
+void
+MultiDestApp::SendPacket (void)
+{
+  if (m_mode == ROUND_ROBIN)
+    {
+      m_next %= m_active.size ();
+      uint32_t index = m_active[m_next];
+      SendToDestination (index);
+      if (m_destinations[index].packetsSent == m_nPackets)
+        {
+          m_active.erase (m_active.begin () + m_next);
+        }
+      else
+        {
+          m_next++;
+        }
+    }
+  else
+    {
+      for (uint32_t k = 0; k < m_active.size (); )
+        {
+          SendToDestination (m_active[k]);
+          if (m_destinations[m_active[k]].packetsSent == m_nPackets)
+            {
+              m_active.erase (m_active.begin () + k);
+            }
+          else
+            {
+              k++;
+            }
+        }
+    }
+  ScheduleTx ();
+}
+
+void
+MultiDestApp::SendToDestination (uint32_t index)
+{
+  Destination &dest = m_destinations[index];
+
+  ProbeHeader header;
+  uint32_t payloadSize = m_packetSize;
+  if (m_registry && dest.probeId != 0)
+    {
+      payloadSize = m_packetSize > header.GetSerializedSize () ? m_packetSize - header.GetSerializedSize () : 0;
+    }
+  Ptr<Packet> packet;
+  if (MyApp::GetPacketReuse ())
+    {
+      if (!m_template || m_template->GetSize () != payloadSize)
+        {
+          m_template = Create<Packet> (payloadSize);
+        }
+      packet = m_template->Copy ();
+    }
+  else
+    {
+      packet = Create<Packet> (payloadSize);
+    }
+
+  if (m_registry && dest.probeId != 0)
+    {
+      header.SetFlowId (dest.probeId);
+      header.SetSeq (dest.packetsSent);
+      header.SetTxTime (Simulator::Now ());
+      packet->AddHeader (header);
+      m_registry->RecordTx (dest.probeId, packet->GetSize ());
+    }
+
+  m_socket->SendTo (packet, 0, dest.address);
+  dest.packetsSent++;
+}
+
+void
+MultiDestApp::ScheduleTx (void)
+{
+  if (m_running && !m_active.empty ())
+    {
+      // ROUND_ROBIN chia khoảng cách gói của một cặp cho các đích đang gửi
+      Time interval = m_mode == ROUND_ROBIN ? Seconds (m_pairInterval.GetSeconds () / m_active.size ()) : m_pairInterval;
+      m_sendEvent = Simulator::Schedule (interval, &MultiDestApp::SendPacket, this);
+    }
+}
+
+#endif /* MULTIAPP_H */
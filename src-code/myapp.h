@@ -1,3 +1,6 @@
+#ifndef MYAPP_H
+#define MYAPP_H
+
 #include "ns3/applications-module.h"
 #include "ns3/core-module.h"
 
@@ -13,12 +16,15 @@ public:
 
   void Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint32_t nPackets, DataRate dataRate);
 
-private:
-  virtual void StartApplication (void);
-  virtual void StopApplication (void);
+  // Bật/tắt dùng lại gói tin mẫu cho mọi MyApp và MultiDestApp (để so sánh hiệu năng)
+  static void SetPacketReuse (bool reuse);
+  static bool GetPacketReuse (void);
 
-  void ScheduleTx (void);
-  void SendPacket (void);
+protected:
+  // Tạo gói tin cho lần gửi tiếp theo; lớp con có thể gắn thêm header
+  virtual Ptr<Packet> BuildPacket (void);
+  // Bản sao của gói tin mẫu có payload với kích thước cho trước
+  Ptr<Packet> CopyPayload (uint32_t size);
 
   Ptr<Socket>     m_socket;
   Address         m_peer;
@@ -28,8 +34,21 @@ private:
   EventId         m_sendEvent;
   bool            m_running;
   uint32_t        m_packetsSent;
+  Time            m_interval;    // khoảng cách giữa hai gói, tính một lần ở Setup
+  Ptr<Packet>     m_template;
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  void ScheduleTx (void);
+  void SendPacket (void);
+
+  static bool     s_packetReuse;
 };
 
+bool MyApp::s_packetReuse = true;
+
 MyApp::MyApp ()
   : m_socket (0),
     m_peer (),
@@ -38,7 +57,9 @@ MyApp::MyApp ()
     m_dataRate (0),
     m_sendEvent (),
     m_running (false),
-    m_packetsSent (0)
+    m_packetsSent (0),
+    m_interval (),
+    m_template (0)
 {
 }
 
@@ -55,6 +76,19 @@ MyApp::Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint32_t
   m_packetSize = packetSize;
   m_nPackets = nPackets;
   m_dataRate = dataRate;
+  m_interval = Seconds (m_packetSize * 8 / static_cast<double> (m_dataRate.GetBitRate ()));
+}
+
+void
+MyApp::SetPacketReuse (bool reuse)
+{
+  s_packetReuse = reuse;
+}
+
+bool
+MyApp::GetPacketReuse (void)
+{
+  return s_packetReuse;
 }
 
 void
@@ -86,7 +120,7 @@ MyApp::StopApplication (void)
 void
 MyApp::SendPacket (void)
 {
-  Ptr<Packet> packet = Create<Packet> (m_packetSize);
+  Ptr<Packet> packet = BuildPacket ();
   m_socket->Send (packet);
 
   if (++m_packetsSent < m_nPackets)
@@ -95,12 +129,35 @@ MyApp::SendPacket (void)
     }
 }
 
+Ptr<Packet>
+MyApp::BuildPacket (void)
+{
+  return CopyPayload (m_packetSize);
+}
+
+Ptr<Packet>
+MyApp::CopyPayload (uint32_t size)
+{
+  if (!s_packetReuse)
+    {
+      return Create<Packet> (size);
+    }
+  // Copy() chỉ chia sẻ buffer (copy-on-write) nên không cấp phát payload mới.
+  // Các bản sao có chung UID; tag thêm vào sau đó là riêng của từng bản sao.
+  if (!m_template || m_template->GetSize () != size)
+    {
+      m_template = Create<Packet> (size);
+    }
+  return m_template->Copy ();
+}
+
 void
 MyApp::ScheduleTx (void)
 {
   if (m_running)
     {
-      Time tNext (Seconds (m_packetSize * 8 / static_cast<double> (m_dataRate.GetBitRate ())));
-      m_sendEvent = Simulator::Schedule (tNext, &MyApp::SendPacket, this);
+      m_sendEvent = Simulator::Schedule (m_interval, &MyApp::SendPacket, this);
     }
 }
+
+#endif /* MYAPP_H */
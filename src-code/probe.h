@@ -0,0 +1,454 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "myapp.h"
+
+#include <vector>
+
+using namespace ns3;
+
+
+// Header gắn vào đầu mỗi gói tin đo: flow, số thứ tự và thời điểm gửi
+class ProbeHeader : public Header
+{
+public:
+  ProbeHeader ();
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+  void SetFlowId (uint32_t flowId);
+  uint32_t GetFlowId (void) const;
+  void SetSeq (uint32_t seq);
+  uint32_t GetSeq (void) const;
+  void SetTxTime (Time txTime);
+  Time GetTxTime (void) const;
+
+private:
+  uint32_t m_flowId;
+  uint32_t m_seq;
+  uint64_t m_txTime;  // ns
+};
+
+// Bộ đếm của các flow đo ở tầng ứng dụng, lưu trong mảng phẳng đánh chỉ số
+// theo FlowId. Dùng lại FlowMonitor::FlowStats để MetricsEngine đọc được
+// như khi lấy từ FlowMonitor, nhưng không cần gắn probe vào IP của mọi node.
+class ProbeRegistry
+{
+public:
+  ProbeRegistry ();
+
+  FlowId AddFlow (Ipv4Address source, Ipv4Address destination, uint16_t port);
+  void RecordTx (FlowId id, uint32_t bytes);
+  void RecordRx (const ProbeHeader &header, uint32_t bytes);
+
+  // Phần tử 0 không dùng, FlowId bắt đầu từ 1 như FlowMonitor
+  const std::vector<FlowMonitor::FlowStats> &GetFlowStats (void) const;
+  const Ipv4FlowClassifier::FiveTuple &GetTuple (FlowId id) const;
+  uint32_t GetReordered (FlowId id) const;
+  uint64_t GetTotalReordered (void) const;
+
+private:
+  static void UpdateLost (FlowMonitor::FlowStats &st);
+
+  std::vector<FlowMonitor::FlowStats>         m_stats;
+  std::vector<Ipv4FlowClassifier::FiveTuple>  m_tuples;
+  std::vector<uint32_t>                       m_nextSeq;    // số thứ tự lớn nhất đã nhận + 1
+  std::vector<uint32_t>                       m_reordered;  // số gói đến sau gói có số thứ tự lớn hơn
+};
+
+// Biến thể của MyApp gắn ProbeHeader vào mỗi gói tin gửi đi
+class ProbeApp : public MyApp
+{
+public:
+  ProbeApp ();
+
+  void SetProbe (ProbeRegistry *registry, FlowId flowId);
+
+protected:
+  virtual Ptr<Packet> BuildPacket (void);
+
+private:
+  ProbeRegistry  *m_registry;
+  FlowId          m_flowId;
+};
+
+// Sink tính độ trễ, mất gói và đảo thứ tự từ ProbeHeader của gói nhận được
+class ProbeSink : public Application
+{
+public:
+  ProbeSink ();
+  virtual ~ProbeSink();
+
+  void Setup (uint16_t port, ProbeRegistry *registry);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  void HandleRead (Ptr<Socket> socket);
+
+  Ptr<Socket>     m_socket;
+  uint16_t        m_port;
+  ProbeRegistry  *m_registry;
+};
+
+// Tạo ứng dụng gửi: ProbeApp đã đăng ký flow khi có registry, MyApp nếu không
+Ptr<MyApp> CreateSenderApp (ProbeRegistry *registry, Ipv4Address source,
+                            Ipv4Address destination, uint16_t port);
+
+// Cài ProbeSink lắng nghe trên cổng cho trước ở mọi node trong container
+ApplicationContainer InstallProbeSinks (NodeContainer nodes, uint16_t port, ProbeRegistry *registry);
+
+NS_OBJECT_ENSURE_REGISTERED (ProbeHeader);
+
+ProbeHeader::ProbeHeader ()
+  : m_flowId (0),
+    m_seq (0),
+    m_txTime (0)
+{
+}
+
+TypeId
+ProbeHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProbeHeader")
+    .SetParent<Header> ()
+    .AddConstructor<ProbeHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+ProbeHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+ProbeHeader::GetSerializedSize (void) const
+{
+  return 4 + 4 + 8;
+}
+
+void
+ProbeHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteHtonU32 (m_flowId);
+  start.WriteHtonU32 (m_seq);
+  start.WriteHtonU64 (m_txTime);
+}
+
+uint32_t
+ProbeHeader::Deserialize (Buffer::Iterator start)
+{
+  m_flowId = start.ReadNtohU32 ();
+  m_seq = start.ReadNtohU32 ();
+  m_txTime = start.ReadNtohU64 ();
+  return GetSerializedSize ();
+}
+
+void
+ProbeHeader::Print (std::ostream &os) const
+{
+  os << "flow=" << m_flowId << " seq=" << m_seq << " tx=" << GetTxTime ();
+}
+
+void
+ProbeHeader::SetFlowId (uint32_t flowId)
+{
+  m_flowId = flowId;
+}
+
+uint32_t
+ProbeHeader::GetFlowId (void) const
+{
+  return m_flowId;
+}
+
+void
+ProbeHeader::SetSeq (uint32_t seq)
+{
+  m_seq = seq;
+}
+
+uint32_t
+ProbeHeader::GetSeq (void) const
+{
+  return m_seq;
+}
+
+void
+ProbeHeader::SetTxTime (Time txTime)
+{
+  m_txTime = txTime.GetNanoSeconds ();
+}
+
+Time
+ProbeHeader::GetTxTime (void) const
+{
+  return NanoSeconds (m_txTime);
+}
+
+ProbeRegistry::ProbeRegistry ()
+  : m_stats (1),
+    m_tuples (1),
+    m_nextSeq (1, 0),
+    m_reordered (1, 0)
+{
+}
+
+FlowId
+ProbeRegistry::AddFlow (Ipv4Address source, Ipv4Address destination, uint16_t port)
+{
+  FlowMonitor::FlowStats st;
+  st.delaySum = Seconds (0);
+  st.jitterSum = Seconds (0);
+  st.lastDelay = Seconds (0);
+  st.txBytes = 0;
+  st.rxBytes = 0;
+  st.txPackets = 0;
+  st.rxPackets = 0;
+  st.lostPackets = 0;
+  st.timesForwarded = 0;
+  // Cùng độ rộng bin với cấu hình FlowMonitor trong các kịch bản
+  st.delayHistogram.SetDefaultBinWidth (0.001);
+  st.jitterHistogram.SetDefaultBinWidth (0.001);
+  st.packetSizeHistogram.SetDefaultBinWidth (20);
+  m_stats.push_back (st);
+
+  Ipv4FlowClassifier::FiveTuple tuple;
+  tuple.sourceAddress = source;
+  tuple.destinationAddress = destination;
+  tuple.protocol = UdpL4Protocol::PROT_NUMBER;
+  tuple.sourcePort = 0;  // cổng nguồn do socket tự chọn
+  tuple.destinationPort = port;
+  m_tuples.push_back (tuple);
+
+  m_nextSeq.push_back (0);
+  m_reordered.push_back (0);
+  return m_stats.size () - 1;
+}
+
+void
+ProbeRegistry::RecordTx (FlowId id, uint32_t bytes)
+{
+  FlowMonitor::FlowStats &st = m_stats[id];
+  Time now = Simulator::Now ();
+  if (st.txPackets == 0)
+    {
+      st.timeFirstTxPacket = now;
+    }
+  st.timeLastTxPacket = now;
+  st.txPackets++;
+  st.txBytes += bytes;
+  UpdateLost (st);
+}
+
+void
+ProbeRegistry::RecordRx (const ProbeHeader &header, uint32_t bytes)
+{
+  FlowId id = header.GetFlowId ();
+  if (id == 0 || id >= m_stats.size ())
+    {
+      return;
+    }
+
+  FlowMonitor::FlowStats &st = m_stats[id];
+  Time now = Simulator::Now ();
+  Time delay = now - header.GetTxTime ();
+
+  // Jitter tính như FlowMonitor: chênh lệch độ trễ của hai gói liên tiếp
+  if (st.rxPackets > 0)
+    {
+      Time jitter = delay > st.lastDelay ? delay - st.lastDelay : st.lastDelay - delay;
+      st.jitterSum += jitter;
+      st.jitterHistogram.AddValue (jitter.GetSeconds ());
+    }
+  else
+    {
+      st.timeFirstRxPacket = now;
+    }
+  st.timeLastRxPacket = now;
+  st.lastDelay = delay;
+  st.delaySum += delay;
+  st.delayHistogram.AddValue (delay.GetSeconds ());
+  st.packetSizeHistogram.AddValue (bytes);
+  st.rxPackets++;
+  st.rxBytes += bytes;
+
+  // Gói có số thứ tự nhỏ hơn gói đã nhận trước đó là gói đến sai thứ tự
+  uint32_t seq = header.GetSeq ();
+  if (seq < m_nextSeq[id])
+    {
+      m_reordered[id]++;
+    }
+  else
+    {
+      m_nextSeq[id] = seq + 1;
+    }
+  UpdateLost (st);
+}
+
+void
+ProbeRegistry::UpdateLost (FlowMonitor::FlowStats &st)
+{
+  // Gói đã gửi mà chưa nhận được, kể cả flow chưa nhận gói nào và các gói
+  // gửi sau gói nhận cuối cùng; gói đang trên đường cũng được tính
+  st.lostPackets = st.txPackets > st.rxPackets ? st.txPackets - st.rxPackets : 0;
+}
+
+const std::vector<FlowMonitor::FlowStats> &
+ProbeRegistry::GetFlowStats (void) const
+{
+  return m_stats;
+}
+
+const Ipv4FlowClassifier::FiveTuple &
+ProbeRegistry::GetTuple (FlowId id) const
+{
+  return m_tuples[id];
+}
+
+uint32_t
+ProbeRegistry::GetReordered (FlowId id) const
+{
+  return m_reordered[id];
+}
+
+uint64_t
+ProbeRegistry::GetTotalReordered (void) const
+{
+  uint64_t total = 0;
+  for (uint32_t reordered : m_reordered)
+    {
+      total += reordered;
+    }
+  return total;
+}
+
+ProbeApp::ProbeApp ()
+  : m_registry (0),
+    m_flowId (0)
+{
+}
+
+void
+ProbeApp::SetProbe (ProbeRegistry *registry, FlowId flowId)
+{
+  m_registry = registry;
+  m_flowId = flowId;
+}
+
+Ptr<Packet>
+ProbeApp::BuildPacket (void)
+{
+  ProbeHeader header;
+  header.SetFlowId (m_flowId);
+  header.SetSeq (m_packetsSent);
+  header.SetTxTime (Simulator::Now ());
+
+  // Giữ nguyên kích thước gói tin của MyApp, header nằm trong phần payload
+  uint32_t headerSize = header.GetSerializedSize ();
+  Ptr<Packet> packet = CopyPayload (m_packetSize > headerSize ? m_packetSize - headerSize : 0);
+  packet->AddHeader (header);
+
+  if (m_registry)
+    {
+      m_registry->RecordTx (m_flowId, packet->GetSize ());
+    }
+  return packet;
+}
+
+ProbeSink::ProbeSink ()
+  : m_socket (0),
+    m_port (0),
+    m_registry (0)
+{
+}
+
+ProbeSink::~ProbeSink()
+{
+  m_socket = 0;
+}
+
+void
+ProbeSink::Setup (uint16_t port, ProbeRegistry *registry)
+{
+  m_port = port;
+  m_registry = registry;
+}
+
+void
+ProbeSink::StartApplication (void)
+{
+  if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+      m_socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+    }
+  m_socket->SetRecvCallback (MakeCallback (&ProbeSink::HandleRead, this));
+}
+
+void
+ProbeSink::StopApplication (void)
+{
+  if (m_socket)
+    {
+      m_socket->Close ();
+      m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+    }
+}
+
+void
+ProbeSink::HandleRead (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      ProbeHeader header;
+      if (packet->GetSize () < header.GetSerializedSize ())
+        {
+          continue;
+        }
+      packet->PeekHeader (header);
+      m_registry->RecordRx (header, packet->GetSize ());
+    }
+}
+
+Ptr<MyApp>
+CreateSenderApp (ProbeRegistry *registry, Ipv4Address source,
+                 Ipv4Address destination, uint16_t port)
+{
+  if (!registry)
+    {
+      return CreateObject<MyApp> ();
+    }
+  Ptr<ProbeApp> app = CreateObject<ProbeApp> ();
+  app->SetProbe (registry, registry->AddFlow (source, destination, port));
+  return app;
+}
+
+ApplicationContainer
+InstallProbeSinks (NodeContainer nodes, uint16_t port, ProbeRegistry *registry)
+{
+  ApplicationContainer apps;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ProbeSink> sink = CreateObject<ProbeSink> ();
+      sink->Setup (port, registry);
+      nodes.Get (i)->AddApplication (sink);
+      apps.Add (sink);
+    }
+  return apps;
+}
+
+#endif /* PROBE_H */
@@ -0,0 +1,290 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+
+// Scheduler bọc một scheduler thật (mặc định MapScheduler) để đo thời gian thực
+// của từng sự kiện. Simulator lấy sự kiện qua RemoveNext rồi chạy ngay, nên thời
+// gian từ một lần RemoveNext tới lần kế tiếp thuộc về sự kiện được lấy trước đó.
+// Sự kiện được gom theo kiểu EventImpl: với Simulator::Schedule (&Class::Method, obj)
+// kiểu này chứa tên lớp (MyApp, YansWifiPhy, olsr::RoutingProtocol...), bộ đếm chỉ
+// là một lần typeid và một lần tra bảng băm cho mỗi sự kiện.
+// Chỉ được cài khi bật Profile, nếu không Simulator dùng scheduler gốc như cũ.
+class ProfilingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  ProfilingScheduler ();
+  virtual ~ProfilingScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+  // Khép thời gian của sự kiện cuối cùng; gọi ngay khi Simulator::Run trả về để
+  // phần dọn dẹp sau đó không bị tính cho sự kiện này
+  void StopAccounting (void);
+  // Bảng phẳng sắp theo thời gian thực giảm dần
+  void PrintProfile (std::ostream &os);
+  // Scheduler đang được Simulator dùng (0 nếu không bật Profile)
+  static ProfilingScheduler *GetInstance (void);
+
+private:
+  struct Counter
+  {
+    Counter ();
+
+    uint64_t count;
+    uint64_t cancelled;
+    double   wall;       // giây
+  };
+
+  typedef std::chrono::steady_clock Clock;
+
+  void SetScheduler (const ObjectFactory &factory);
+  // Cộng thời gian từ lần RemoveNext trước cho sự kiện trước
+  void Account (Clock::time_point now);
+  static std::string Demangle (const char *name);
+  // "void (ns3::MyApp::*)()" -> "MyApp"
+  static std::string Component (const std::string &callback);
+
+  Ptr<Scheduler>                                m_scheduler;
+  std::unordered_map<std::type_index, Counter>  m_counters;
+  Counter                                      *m_current;
+  Clock::time_point                             m_last;
+
+  static ProfilingScheduler                    *m_instance;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (ProfilingScheduler);
+
+ProfilingScheduler *ProfilingScheduler::m_instance = 0;
+
+TypeId
+ProfilingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfilingScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ProfilingScheduler> ()
+    .AddAttribute ("Scheduler", "Scheduler that actually stores the events",
+                   ObjectFactoryValue (ObjectFactory ("ns3::MapScheduler")),
+                   MakeObjectFactoryAccessor (&ProfilingScheduler::SetScheduler),
+                   MakeObjectFactoryChecker ())
+  ;
+  return tid;
+}
+
+ProfilingScheduler::Counter::Counter ()
+  : count (0),
+    cancelled (0),
+    wall (0.0)
+{
+}
+
+ProfilingScheduler::ProfilingScheduler ()
+  : m_current (0)
+{
+  m_scheduler = CreateObject<MapScheduler> ();
+  m_instance = this;
+}
+
+ProfilingScheduler::~ProfilingScheduler ()
+{
+  if (m_instance == this)
+    {
+      m_instance = 0;
+    }
+}
+
+ProfilingScheduler *
+ProfilingScheduler::GetInstance (void)
+{
+  return m_instance;
+}
+
+void
+ProfilingScheduler::SetScheduler (const ObjectFactory &factory)
+{
+  NS_ABORT_MSG_UNLESS (IsEmpty (), "Set the inner scheduler before scheduling events");
+  m_scheduler = factory.Create<Scheduler> ();
+}
+
+void
+ProfilingScheduler::Insert (const Event &ev)
+{
+  m_scheduler->Insert (ev);
+}
+
+bool
+ProfilingScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+ProfilingScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+ProfilingScheduler::RemoveNext (void)
+{
+  Account (Clock::now ());
+  Event ev = m_scheduler->RemoveNext ();
+  m_current = &m_counters[std::type_index (typeid (*ev.impl))];
+  m_current->count++;
+  if (ev.impl->IsCancelled ())
+    {
+      m_current->cancelled++;
+    }
+  return ev;
+}
+
+void
+ProfilingScheduler::Remove (const Event &ev)
+{
+  m_scheduler->Remove (ev);
+}
+
+void
+ProfilingScheduler::Account (Clock::time_point now)
+{
+  if (m_current)
+    {
+      m_current->wall += std::chrono::duration<double> (now - m_last).count ();
+    }
+  m_last = now;
+}
+
+std::string
+ProfilingScheduler::Demangle (const char *name)
+{
+  int status = 0;
+  char *demangled = abi::__cxa_demangle (name, 0, 0, &status);
+  if (status != 0 || !demangled)
+    {
+      return name;
+    }
+  std::string result (demangled);
+  std::free (demangled);
+  return result;
+}
+
+std::string
+ProfilingScheduler::Component (const std::string &callback)
+{
+  // Con trỏ hàm thành viên: "(ns3::Lớp::*)"
+  std::string::size_type end = callback.find ("::*)");
+  if (end != std::string::npos)
+    {
+      std::string::size_type begin = callback.rfind ('(', end);
+      std::string name = callback.substr (begin + 1, end - begin - 1);
+      if (name.compare (0, 5, "ns3::") == 0)
+        {
+          name = name.substr (5);
+        }
+      return name;
+    }
+  // Hàm tự do: "(*)(...)"
+  if (callback.find ("(*)") != std::string::npos)
+    {
+      return "<function>";
+    }
+  return "<other>";
+}
+
+void
+ProfilingScheduler::StopAccounting (void)
+{
+  // Sự kiện cuối cùng chạy tới lúc Simulator dừng
+  Account (Clock::now ());
+  m_current = 0;
+}
+
+void
+ProfilingScheduler::PrintProfile (std::ostream &os)
+{
+  // Không đổi gì nếu StopAccounting đã được gọi
+  StopAccounting ();
+
+  struct Row
+  {
+    std::string component;
+    std::string callback;
+    Counter     counter;
+  };
+  std::vector<Row> rows;
+  std::unordered_map<std::string, Counter> components;
+  double totalWall = 0.0;
+  uint64_t totalCount = 0;
+  for (const auto &entry : m_counters)
+    {
+      Row row;
+      row.callback = Demangle (entry.first.name ());
+      row.component = Component (row.callback);
+      row.counter = entry.second;
+      rows.push_back (row);
+
+      Counter &c = components[row.component];
+      c.count += entry.second.count;
+      c.cancelled += entry.second.cancelled;
+      c.wall += entry.second.wall;
+      totalWall += entry.second.wall;
+      totalCount += entry.second.count;
+    }
+  std::sort (rows.begin (), rows.end (),
+             [] (const Row &a, const Row &b) { return a.counter.wall > b.counter.wall; });
+
+  os << "========== PROFILE THEO THÀNH PHẦN ==========" << std::endl;
+  os << std::setw (12) << "Sự kiện" << std::setw (12) << "Đã hủy" << std::setw (12) << "Thời gian (s)"
+     << std::setw (8) << "%" << std::setw (12) << "us/sự kiện" << "  Thành phần" << std::endl;
+  std::vector<std::pair<std::string, Counter> > sorted (components.begin (), components.end ());
+  std::sort (sorted.begin (), sorted.end (),
+             [] (const std::pair<std::string, Counter> &a, const std::pair<std::string, Counter> &b)
+             { return a.second.wall > b.second.wall; });
+  for (const auto &entry : sorted)
+    {
+      const Counter &c = entry.second;
+      os << std::setw (12) << c.count << std::setw (12) << c.cancelled
+         << std::setw (12) << std::fixed << std::setprecision (3) << c.wall
+         << std::setw (8) << std::setprecision (1) << (totalWall > 0 ? 100.0 * c.wall / totalWall : 0.0)
+         << std::setw (12) << std::setprecision (2) << (c.count > 0 ? 1e6 * c.wall / c.count : 0.0)
+         << "  " << entry.first << std::endl;
+    }
+
+  os << "========== PROFILE THEO CALLBACK ==========" << std::endl;
+  for (const Row &row : rows)
+    {
+      const Counter &c = row.counter;
+      os << std::setw (12) << c.count << std::setw (12) << c.cancelled
+         << std::setw (12) << std::fixed << std::setprecision (3) << c.wall
+         << std::setw (8) << std::setprecision (1) << (totalWall > 0 ? 100.0 * c.wall / totalWall : 0.0)
+         << std::setw (12) << std::setprecision (2) << (c.count > 0 ? 1e6 * c.wall / c.count : 0.0)
+         << "  " << row.callback << std::endl;
+    }
+  os << "Tổng: " << totalCount << " sự kiện, " << std::setprecision (3) << totalWall << " s" << std::endl;
+  os.unsetf (std::ios_base::floatfield);
+  os << std::setprecision (6);
+}
+
+#endif /* PROFILER_H */
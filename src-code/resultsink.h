@@ -0,0 +1,178 @@
+#ifndef RESULTSINK_H
+#define RESULTSINK_H
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace ns3;
+
+
+// Đích ghi kết quả (file CSV hoặc stdout) không chặn luồng mô phỏng: văn bản
+// đã định dạng được nối vào bộ đệm trong bộ nhớ, một luồng nền đổi bộ đệm và
+// ghi ra đĩa khi bộ đệm đủ lớn, sau mỗi FlushInterval hoặc khi đóng.
+// Luồng nền không còn sau fork(): đóng trước khi fork và mở lại ở tiến trình con.
+// OpenCommand ghi vào stdin của một lệnh shell (ví dụ gzip) thay vì file.
+class ResultSink
+{
+public:
+  ResultSink ();
+  ~ResultSink ();
+
+  bool Open (const std::string &path);
+  bool OpenCommand (const std::string &command);
+  void OpenStdout (void);
+  bool IsOpen (void) const;
+  void Write (const std::string &text);
+  // Ghi hết bộ đệm và dừng luồng nền
+  void Close (void);
+
+private:
+  void Start (std::FILE *file, bool owned, bool pipe = false);
+  void Loop (void);
+
+  static constexpr std::size_t FLUSH_BYTES = 1 << 16;
+  static constexpr int FLUSH_INTERVAL_MS = 500;
+
+  std::FILE              *m_file;
+  bool                    m_owned;      // false với stdout
+  bool                    m_pipe;       // mở bằng popen, đóng bằng pclose
+  std::string             m_front;      // luồng mô phỏng ghi vào
+  std::string             m_back;       // luồng nền ghi ra file
+  std::mutex              m_mutex;
+  std::condition_variable m_wake;
+  bool                    m_closing;
+  std::thread             m_thread;
+};
+
+ResultSink::ResultSink ()
+  : m_file (0),
+    m_owned (false),
+    m_pipe (false),
+    m_closing (false)
+{
+}
+
+ResultSink::~ResultSink ()
+{
+  Close ();
+}
+
+bool
+ResultSink::Open (const std::string &path)
+{
+  std::FILE *file = std::fopen (path.c_str (), "w");
+  if (!file)
+    {
+      return false;
+    }
+  Start (file, true);
+  return true;
+}
+
+bool
+ResultSink::OpenCommand (const std::string &command)
+{
+  std::FILE *file = popen (command.c_str (), "w");
+  if (!file)
+    {
+      return false;
+    }
+  Start (file, true, true);
+  return true;
+}
+
+void
+ResultSink::OpenStdout (void)
+{
+  Start (stdout, false);
+}
+
+bool
+ResultSink::IsOpen (void) const
+{
+  return m_file != 0;
+}
+
+void
+ResultSink::Start (std::FILE *file, bool owned, bool pipe)
+{
+  Close ();
+  m_file = file;
+  m_owned = owned;
+  m_pipe = pipe;
+  m_closing = false;
+  m_thread = std::thread (&ResultSink::Loop, this);
+}
+
+void
+ResultSink::Write (const std::string &text)
+{
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_front += text;
+    wake = m_front.size () >= FLUSH_BYTES;
+  }
+  if (wake)
+    {
+      m_wake.notify_one ();
+    }
+}
+
+void
+ResultSink::Loop (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_wake.wait_for (lock, std::chrono::milliseconds (FLUSH_INTERVAL_MS),
+                       [this] { return m_closing || m_front.size () >= FLUSH_BYTES; });
+      bool closing = m_closing;
+      m_back.swap (m_front);
+      lock.unlock ();
+      if (!m_back.empty ())
+        {
+          std::fwrite (m_back.data (), 1, m_back.size (), m_file);
+          std::fflush (m_file);
+          m_back.clear ();
+        }
+      lock.lock ();
+      if (closing && m_front.empty ())
+        {
+          return;
+        }
+    }
+}
+
+void
+ResultSink::Close (void)
+{
+  if (!m_file)
+    {
+      return;
+    }
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_closing = true;
+  }
+  m_wake.notify_one ();
+  m_thread.join ();
+  if (m_pipe)
+    {
+      // Chờ lệnh (gzip) ghi xong
+      pclose (m_file);
+    }
+  else if (m_owned)
+    {
+      std::fclose (m_file);
+    }
+  m_file = 0;
+}
+
+#endif /* RESULTSINK_H */
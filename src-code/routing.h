@@ -0,0 +1,168 @@
+#ifndef ROUTING_H
+#define ROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/aodv-module.h"
+#include "ns3/olsr-module.h"
+#include "scenario.h"
+
+#include <ostream>
+
+using namespace ns3;
+
+
+// Đếm gói điều khiển OLSR (HELLO, TC, HNA) mà mọi node phát ra, để so với
+// bản tin của controller định tuyến tập trung. Byte gồm cả IP và UDP.
+class OlsrOverhead
+{
+public:
+  OlsrOverhead ();
+
+  // Gọi sau khi OLSR đã được cài lên các node
+  void Install (void);
+  void Report (std::ostream &os) const;
+
+private:
+  static void Tx (OlsrOverhead *overhead, const olsr::PacketHeader &header, const olsr::MessageList &messages);
+
+  uint64_t m_packets;
+  uint64_t m_messages;
+  uint64_t m_bytes;
+};
+
+// Định tuyến ad-hoc AODV trên mọi node
+class AodvRoutingStrategy : public VanetRoutingStrategy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual std::string GetName (void) const;
+  virtual void ConfigureInternet (InternetStackHelper &internet);
+
+private:
+  AodvHelper            m_aodv;
+  Ipv4ListRoutingHelper m_list;
+};
+
+// Định tuyến ad-hoc OLSR, Hello 2s và TC 5s
+class OlsrRoutingStrategy : public VanetRoutingStrategy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual std::string GetName (void) const;
+  virtual void ConfigureInternet (InternetStackHelper &internet);
+  virtual void InstallInfrastructure (VanetScenario &scenario);
+  virtual void Report (std::ostream &os);
+
+private:
+  OlsrHelper            m_olsr;
+  Ipv4ListRoutingHelper m_list;
+  OlsrOverhead          m_overhead;
+};
+
+const uint32_t OLSR_IP_UDP_BYTES = 28;
+
+OlsrOverhead::OlsrOverhead ()
+  : m_packets (0),
+    m_messages (0),
+    m_bytes (0)
+{
+}
+
+void
+OlsrOverhead::Install (void)
+{
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::olsr::RoutingProtocol/Tx",
+                                 MakeBoundCallback (&OlsrOverhead::Tx, this));
+}
+
+void
+OlsrOverhead::Tx (OlsrOverhead *overhead, const olsr::PacketHeader &header, const olsr::MessageList &messages)
+{
+  overhead->m_packets++;
+  overhead->m_messages += messages.size ();
+  overhead->m_bytes += header.GetPacketLength () + OLSR_IP_UDP_BYTES;
+}
+
+void
+OlsrOverhead::Report (std::ostream &os) const
+{
+  double seconds = Simulator::Now ().GetSeconds ();
+  os << "Điều khiển OLSR: " << m_packets << " gói, " << m_messages << " bản tin, " << m_bytes << " byte";
+  if (seconds > 0)
+    {
+      os << " (" << m_bytes * 8.0 / seconds / 1000.0 << " kbit/s)";
+    }
+  os << std::endl;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (AodvRoutingStrategy);
+NS_OBJECT_ENSURE_REGISTERED (OlsrRoutingStrategy);
+
+TypeId
+AodvRoutingStrategy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AodvRoutingStrategy")
+    .SetParent<VanetRoutingStrategy> ()
+    .SetGroupName ("Vanet")
+    .AddConstructor<AodvRoutingStrategy> ()
+  ;
+  return tid;
+}
+
+std::string
+AodvRoutingStrategy::GetName (void) const
+{
+  return "AODV";
+}
+
+void
+AodvRoutingStrategy::ConfigureInternet (InternetStackHelper &internet)
+{
+  // InternetStackHelper chỉ giữ bản sao nên helper sống cùng chiến lược là đủ
+  m_list.Add (m_aodv, 10);
+  internet.SetRoutingHelper (m_list);
+}
+
+TypeId
+OlsrRoutingStrategy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OlsrRoutingStrategy")
+    .SetParent<VanetRoutingStrategy> ()
+    .SetGroupName ("Vanet")
+    .AddConstructor<OlsrRoutingStrategy> ()
+  ;
+  return tid;
+}
+
+std::string
+OlsrRoutingStrategy::GetName (void) const
+{
+  return "OLSR";
+}
+
+void
+OlsrRoutingStrategy::ConfigureInternet (InternetStackHelper &internet)
+{
+  // Các giá trị mặc định: HelloInterval=2s, TcInterval=5s
+  m_olsr.Set ("HelloInterval", TimeValue (Seconds (2)));
+  m_olsr.Set ("TcInterval", TimeValue (Seconds (5)));
+  m_list.Add (m_olsr, 10);
+  internet.SetRoutingHelper (m_list);
+}
+
+void
+OlsrRoutingStrategy::InstallInfrastructure (VanetScenario &scenario)
+{
+  m_overhead.Install ();
+}
+
+void
+OlsrRoutingStrategy::Report (std::ostream &os)
+{
+  m_overhead.Report (os);
+}
+
+#endif /* ROUTING_H */
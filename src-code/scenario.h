@@ -0,0 +1,1365 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "myapp.h"
+#include "probe.h"
+#include "multiapp.h"
+#include "spatial.h"
+#include "culledchannel.h"
+#include "losscache.h"
+#include "fleet.h"
+#include "metrics.h"
+#include "profiler.h"
+#include "resultsink.h"
+#include "flowtracewriter.h"
+#include "animtrace.h"
+#include "capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+
+// Tham số của một kịch bản VANET. Mỗi chương trình (aodv, olsr, vanetsdn)
+// chỉ đặt giá trị mặc định riêng rồi để dòng lệnh / file cấu hình ghi đè.
+struct ScenarioConfig
+{
+  ScenarioConfig ();
+
+  void AddCommandLine (CommandLine &cmd);
+  // Đọc --ConfigFile (mỗi dòng Key=Value) trước, tham số dòng lệnh ghi đè lên
+  void Parse (int argc, char *argv[]);
+
+  std::string routing;          // aodv | olsr | sdn hoặc tên TypeId của chiến lược
+  std::string radio;            // 80211b | 80211p
+  std::string mobility;         // random | rsu
+  std::string traffic;          // random | v2x
+  uint32_t    numVehicles;
+  uint32_t    numRsus;
+  std::string rsuLayout;        // line | grid
+  double      areaSize;         // cạnh vùng mô phỏng vuông (m)
+  double      speed;            // m/s
+  double      moveTime;         // thời điểm dừng mọi xe (s)
+  double      simTime;          // thời điểm dừng mô phỏng (s)
+  double      trafficStop;      // thời điểm dừng các ứng dụng gửi (s)
+  double      flowStart;        // traffic random: flow i bắt đầu lúc flowStart + flowStartStep * i
+  double      flowStartStep;
+  std::string dataRate;
+  std::string directRate;       // flow n0 -> n9, rỗng thì dùng dataRate
+  bool        downlink;         // traffic v2x: thêm flow server -> xe cho 10 xe V2I
+  std::string phyMode;          // chế độ PHY của radio 80211b
+  std::string outputFile;
+  std::string animFile;         // rỗng thì không ghi NetAnim, đuôi .gz thì nén
+  double      animStart;        // cửa sổ ghi NetAnim (s)
+  double      animStop;         // <= 0: tới SimTime
+  double      animSampling;     // tỷ lệ gói Wi-Fi được ghi
+  uint32_t    animMaxNodes;     // 0: mọi node
+  double      animPositionInterval;
+  std::string configFile;
+  bool        enableFlowMonitor;
+  std::string metricsMode;
+  double      metricsWindow;
+  bool        useProbes;
+  bool        packetReuse;
+  std::string v2vMode;
+  bool        culledChannel;
+  bool        cachedLoss;
+  double      lossErrorDb;
+  bool        lossReport;       // đo sai số và tốc độ của bảng suy hao trước khi chạy
+  double      warmupTime;       // > 0 cùng forks > 0: chạy chung tới thời điểm này rồi fork()
+  uint32_t    forks;            // số tiến trình con, mỗi con một RngRun
+  uint32_t    forkJobs;         // số tiến trình con chạy cùng lúc, 0 là tất cả
+  bool        profile;          // đo thời gian thực theo từng loại sự kiện
+  uint32_t    verbosity;        // 0: chỉ kết quả cuối, 1: thông số trung bình, 2: chi tiết từng flow
+  std::string flowTrace;        // file chuỗi thời gian nhị phân theo flow, rỗng thì tắt
+  uint32_t    captureBytes;     // bộ đệm vòng pcap cho mỗi thiết bị Wi-Fi, 0 thì tắt
+  double      captureMinPdr;    // ghi pcap khi PDR của cửa sổ dưới ngưỡng (%), 0 thì bỏ qua
+  double      captureMaxDelay;  // ghi pcap khi delay trung bình của cửa sổ vượt ngưỡng (s), 0 thì bỏ qua
+  uint32_t    captureMaxDumps;
+  std::string capturePrefix;
+};
+
+class VanetScenario;
+
+// Giao thức định tuyến / mặt phẳng điều khiển cắm vào kịch bản.
+// Tạo theo tên ngắn (aodv, olsr, sdn) hoặc tên TypeId đầy đủ.
+class VanetRoutingStrategy : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  static Ptr<VanetRoutingStrategy> CreateByName (const std::string &name);
+
+  virtual std::string GetName (void) const = 0;
+  // Đặt routing helper cho mọi node có IP (xe, RSU và hạ tầng)
+  virtual void ConfigureInternet (InternetStackHelper &internet) = 0;
+  // Gọi sau khi xe và RSU đã có địa chỉ: tạo switch, controller, server...
+  virtual void InstallInfrastructure (VanetScenario &scenario);
+  // In thống kê riêng của giao thức sau khi chạy
+  virtual void Report (std::ostream &os);
+};
+
+// Kịch bản dùng chung: tạo xe/RSU, di chuyển, kênh Wi-Fi, lưu lượng và
+// thông số; phần định tuyến do VanetRoutingStrategy đảm nhận.
+class VanetScenario
+{
+public:
+  VanetScenario (const ScenarioConfig &config);
+
+  void Build (void);
+  void Run (void);
+
+  const ScenarioConfig &GetConfig (void) const;
+  Ptr<VanetRoutingStrategy> GetStrategy (void) const;
+  NodeContainer GetVehicles (void) const;
+  NodeContainer GetRsus (void) const;
+  const std::vector<Vector> &GetRsuPositions (void) const;
+  // Địa chỉ Wi-Fi: các xe trước, sau đó tới các RSU
+  Ipv4Address GetVehicleAddress (uint32_t i) const;
+  Ipv4Address GetRsuAddress (uint32_t i) const;
+  InternetStackHelper &GetInternet (void);
+  FleetMobility &GetFleet (void);
+  MetricsEngine &GetMetrics (void);
+  ProbeRegistry *GetProbeRegistry (void);
+  // Server nhận lưu lượng V2I, do chiến lược định tuyến tạo (nếu có); xe V2I
+  // thứ i dùng server i % số server
+  void AddServer (Ptr<Node> server, Ipv4Address address);
+
+private:
+  void BuildNodes (void);
+  void BuildRandomMobility (void);
+  void BuildRsuMobility (void);
+  // Vận tốc của các xe theo profile di chuyển, rút từ RngRun hiện tại
+  void AssignHeadings (void);
+  void BuildWireless (void);
+  void BuildTraffic (void);
+  void BuildRandomTraffic (void);
+  void BuildV2xTraffic (void);
+  // Thời điểm tuyệt đối t đổi sang độ trễ tính từ hiện tại (ứng dụng thêm khi đang chạy)
+  Time At (double t) const;
+  // NetAnim chỉ được cài khi có AnimFile
+  void SetupAnimation (void);
+  void SetupMetrics (void);
+  void LogMetrics (void);
+  // Ghi bộ đệm vòng ra pcap nếu cửa sổ vừa lấy mẫu vượt ngưỡng
+  void CheckCapture (void);
+  void StopMovement (void);
+  void RunToEnd (void);
+  void RunWarmStart (void);
+  void RunChild (uint64_t run);
+  // Dòng CSV vào file kết quả, hoặc giữ trong bộ nhớ cho tới khi fork
+  void WriteCsv (const std::string &text);
+  std::string GetDirectRate (void) const;
+
+  ScenarioConfig                 m_config;
+  Ptr<VanetRoutingStrategy>      m_strategy;
+  NodeContainer                  m_vehicles;
+  NodeContainer                  m_rsus;
+  std::vector<Vector>            m_rsuPositions;
+  SpatialGrid                    m_rsuGrid;
+  Ptr<UniformRandomVariable>     m_headingRandom;  // hướng ngẫu nhiên của xe ở gần RSU
+  Ipv4InterfaceContainer         m_wirelessInterfaces;
+  InternetStackHelper            m_internet;
+  FleetMobility                  m_fleet;
+  NodeContainer                  m_servers;
+  std::vector<Ipv4Address>       m_serverAddresses;
+  Ptr<CulledWifiChannel>         m_culled;
+  AnimTracer                     m_anim;
+  FlowMonitorHelper              m_flowHelper;
+  Ptr<FlowMonitor>               m_flowMonitor;
+  MetricsEngine                  m_metrics;
+  ProbeRegistry                  m_probes;
+  ResultSink                     m_results;
+  ResultSink                     m_console;  // in ra màn hình trong lúc chạy, theo Verbosity
+  FlowTraceWriter                m_flowTrace;
+  RingCapture                    m_capture;
+  std::ostringstream             m_csvHead;  // tiêu đề và các dòng trước khi fork
+};
+
+// Khai báo hằng số khoảng cách - giảm xuống để thực tế hơn
+const double V2V_FLOW_DISTANCE = 30.0; // Phạm vi tạo flow V2V
+const double RSU_GRID_CELL = 100.0;    // Kích thước ô lưới RSU (RSU thưa nên dùng ô lớn)
+const uint16_t V2I_PORT = 9;
+const uint16_t V2V_PORT = 5678;
+const uint16_t V2I_DOWN_PORT = 10;
+
+// Hàm tính hướng di chuyển hướng về RSU. Biến ngẫu nhiên do kịch bản giữ
+// để mỗi lần chạy (RngRun) và mỗi kịch bản có dãy số riêng.
+Vector
+CalculateVelocityTowardsRsu (const Vector &vehiclePos, const Vector &rsuPos, double speed,
+                             UniformRandomVariable &random)
+{
+  Vector direction (rsuPos.x - vehiclePos.x, rsuPos.y - vehiclePos.y, 0);
+  double length = std::sqrt (direction.x * direction.x + direction.y * direction.y);
+
+  // Nếu xe đã ở gần RSU, cho phép di chuyển ngẫu nhiên hơn
+  if (length < 50)
+    {
+      double randomAngle = random.GetValue (0, 2 * M_PI);
+      return Vector (speed * std::cos (randomAngle), speed * std::sin (randomAngle), 0);
+    }
+
+  direction.x = direction.x / length * speed;
+  direction.y = direction.y / length * speed;
+  return direction;
+}
+
+ScenarioConfig::ScenarioConfig ()
+  : routing ("aodv"),
+    radio ("80211b"),
+    mobility ("random"),
+    traffic ("random"),
+    numVehicles (40),
+    numRsus (0),
+    rsuLayout ("line"),
+    areaSize (500.0),
+    speed (5.0),
+    moveTime (60.0),
+    simTime (100.0),
+    trafficStop (60.0),
+    flowStart (10.0),
+    flowStartStep (1.0),
+    dataRate ("250Kbps"),
+    directRate (""),
+    downlink (false),
+    phyMode ("DsssRate1Mbps"),
+    outputFile ("simulation_results.csv"),
+    animFile (""),
+    animStart (0.0),
+    animStop (0.0),
+    animSampling (1.0),
+    animMaxNodes (0),
+    animPositionInterval (1.0),
+    configFile (""),
+    enableFlowMonitor (true),
+    metricsMode ("cumulative"),
+    metricsWindow (1.0),
+    useProbes (false),
+    packetReuse (true),
+    v2vMode ("pair"),
+    culledChannel (false),
+    cachedLoss (false),
+    lossErrorDb (0.01),
+    lossReport (false),
+    warmupTime (0.0),
+    forks (0),
+    forkJobs (0),
+    profile (false),
+    verbosity (1),
+    flowTrace (""),
+    captureBytes (0),
+    captureMinPdr (0.0),
+    captureMaxDelay (0.0),
+    captureMaxDumps (5),
+    capturePrefix ("capture")
+{
+}
+
+void
+ScenarioConfig::AddCommandLine (CommandLine &cmd)
+{
+  cmd.AddValue ("ConfigFile", "File of Key=Value lines applied before the command line", configFile);
+  cmd.AddValue ("Routing", "Routing strategy (aodv|olsr|sdn or a TypeId name)", routing);
+  cmd.AddValue ("Radio", "Wireless profile (80211b|80211p)", radio);
+  cmd.AddValue ("Mobility", "Mobility profile (random|rsu)", mobility);
+  cmd.AddValue ("Traffic", "Traffic profile (random|v2x)", traffic);
+  cmd.AddValue ("NumVehicles", "Number of vehicles (at least 10)", numVehicles);
+  cmd.AddValue ("NumRsus", "Number of RSUs", numRsus);
+  cmd.AddValue ("RsuLayout", "RSU placement (line: along the middle road, grid: over the whole area)", rsuLayout);
+  cmd.AddValue ("AreaSize", "Side of the square simulation area (m)", areaSize);
+  cmd.AddValue ("Speed", "Vehicle speed (m/s)", speed);
+  cmd.AddValue ("MoveTime", "Time at which all vehicles stop (s)", moveTime);
+  cmd.AddValue ("SimTime", "Simulation stop time (s)", simTime);
+  cmd.AddValue ("TrafficStop", "Stop time of sender applications (s)", trafficStop);
+  cmd.AddValue ("FlowStart", "Start time of the first random flow (s)", flowStart);
+  cmd.AddValue ("FlowStartStep", "Start time step between random flows (s)", flowStartStep);
+  cmd.AddValue ("DataRate", "Data rate of the generated flows", dataRate);
+  cmd.AddValue ("DirectRate", "Data rate of the vehicle 0 -> vehicle 9 flow (empty: DataRate)", directRate);
+  cmd.AddValue ("Downlink", "Traffic=v2x: also send from the server to each V2I vehicle", downlink);
+  cmd.AddValue ("phyMode", "Wifi Phy mode of the 80211b radio", phyMode);
+  cmd.AddValue ("OutputFile", "CSV file for per-second results", outputFile);
+  cmd.AddValue ("AnimFile", "NetAnim trace file, gzip-compressed if it ends in .gz (empty to disable)", animFile);
+  cmd.AddValue ("AnimStart", "Start of the NetAnim trace window (s)", animStart);
+  cmd.AddValue ("AnimStop", "End of the NetAnim trace window (s, 0: SimTime)", animStop);
+  cmd.AddValue ("AnimSampling", "Fraction of Wi-Fi packets written to the NetAnim trace (0: positions only)", animSampling);
+  cmd.AddValue ("AnimMaxNodes", "Maximum number of nodes in the NetAnim trace, RSUs and infrastructure first (0: all)", animMaxNodes);
+  cmd.AddValue ("AnimPositionInterval", "Interval between NetAnim position updates (s)", animPositionInterval);
+  cmd.AddValue ("EnableMonitor", "Enable Flow Monitor", enableFlowMonitor);
+  cmd.AddValue ("MetricsMode", "Metrics sampling mode (cumulative|interval)", metricsMode);
+  cmd.AddValue ("MetricsWindow", "Metrics sampling window (s)", metricsWindow);
+  cmd.AddValue ("UseProbes", "Measure KPIs with application-level probes instead of Flow Monitor", useProbes);
+  cmd.AddValue ("PacketReuse", "Send copies of a template packet instead of allocating one per send", packetReuse);
+  cmd.AddValue ("V2VMode", "V2V traffic: one app per pair (pair) or one app per vehicle (roundrobin|fanout)", v2vMode);
+  cmd.AddValue ("CulledChannel", "Only schedule receptions on PHYs within decodable range", culledChannel);
+  cmd.AddValue ("CachedLoss", "Look up propagation loss in a distance-binned table", cachedLoss);
+  cmd.AddValue ("LossErrorDb", "Maximum interpolation error of the loss table (dB)", lossErrorDb);
+  cmd.AddValue ("LossReport", "Benchmark the loss table against the exact model before the run", lossReport);
+  cmd.AddValue ("WarmupTime", "Simulate up to this time once, then fork one child per replication (s)", warmupTime);
+  cmd.AddValue ("Forks", "Number of child processes forked after WarmupTime (RngRun, RngRun+1, ...)", forks);
+  cmd.AddValue ("ForkJobs", "Child processes running at once (0: all)", forkJobs);
+  cmd.AddValue ("Profile", "Attribute wall time and event counts to each callback type", profile);
+  cmd.AddValue ("Verbosity", "Console output: 0 final results, 1 per-sample summary, 2 per-flow details", verbosity);
+  cmd.AddValue ("FlowTrace", "Binary per-flow time series file (empty to disable)", flowTrace);
+  cmd.AddValue ("CaptureBytes", "Per-device in-memory pcap ring buffer size in bytes (0 to disable)", captureBytes);
+  cmd.AddValue ("CaptureMinPdr", "Dump the ring buffers when the sampling window PDR falls below this value (%)", captureMinPdr);
+  cmd.AddValue ("CaptureMaxDelay", "Dump the ring buffers when the sampling window mean delay exceeds this value (s)", captureMaxDelay);
+  cmd.AddValue ("CaptureMaxDumps", "Maximum number of ring buffer dumps", captureMaxDumps);
+  cmd.AddValue ("CapturePrefix", "File prefix of the ring buffer pcap dumps", capturePrefix);
+}
+
+void
+ScenarioConfig::Parse (int argc, char *argv[])
+{
+  CommandLine cmd;
+  AddCommandLine (cmd);
+
+  std::vector<std::string> args (argv, argv + argc);
+  std::string file;
+  for (const std::string &arg : args)
+    {
+      if (arg.compare (0, 13, "--ConfigFile=") == 0)
+        {
+          file = arg.substr (13);
+        }
+    }
+  if (!file.empty ())
+    {
+      std::ifstream in (file);
+      NS_ABORT_MSG_UNLESS (in.is_open (), "Cannot open config file " << file);
+      std::vector<std::string> fileArgs;
+      std::string line;
+      while (std::getline (in, line))
+        {
+          line.erase (0, line.find_first_not_of (" \t"));
+          line.erase (line.find_last_not_of (" \t\r") + 1);
+          if (!line.empty () && line[0] != '#')
+            {
+              fileArgs.push_back ("--" + line);
+            }
+        }
+      args.insert (args.begin () + 1, fileArgs.begin (), fileArgs.end ());
+    }
+  cmd.Parse (args);
+
+  NS_ABORT_MSG_IF (numVehicles < 10, "NumVehicles must be at least 10");
+  NS_ABORT_MSG_IF (radio != "80211b" && radio != "80211p", "Unknown Radio: " << radio);
+  NS_ABORT_MSG_IF (mobility != "random" && mobility != "rsu", "Unknown Mobility: " << mobility);
+  NS_ABORT_MSG_IF (traffic != "random" && traffic != "v2x", "Unknown Traffic: " << traffic);
+  NS_ABORT_MSG_IF (mobility == "rsu" && numRsus == 0, "Mobility=rsu needs NumRsus > 0");
+  NS_ABORT_MSG_IF (rsuLayout != "line" && rsuLayout != "grid", "Unknown RsuLayout: " << rsuLayout);
+  NS_ABORT_MSG_IF (v2vMode != "roundrobin" && v2vMode != "fanout" && v2vMode != "pair",
+                   "Unknown V2VMode: " << v2vMode);
+  NS_ABORT_MSG_IF (downlink && traffic != "v2x", "Downlink needs Traffic=v2x");
+  NS_ABORT_MSG_IF (forks > 0 && (warmupTime <= 0 || warmupTime >= simTime),
+                   "Forks needs 0 < WarmupTime < SimTime");
+  NS_ABORT_MSG_IF (animSampling < 0 || animSampling > 1, "AnimSampling must be in [0, 1]");
+  NS_ABORT_MSG_IF (animPositionInterval <= 0, "AnimPositionInterval must be positive");
+  NS_ABORT_MSG_IF (captureBytes > 0 && captureMinPdr <= 0 && captureMaxDelay <= 0,
+                   "CaptureBytes needs CaptureMinPdr or CaptureMaxDelay");
+}
+
+NS_OBJECT_ENSURE_REGISTERED (VanetRoutingStrategy);
+
+TypeId
+VanetRoutingStrategy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VanetRoutingStrategy")
+    .SetParent<Object> ()
+    .SetGroupName ("Vanet")
+  ;
+  return tid;
+}
+
+Ptr<VanetRoutingStrategy>
+VanetRoutingStrategy::CreateByName (const std::string &name)
+{
+  NS_ABORT_MSG_IF (name.empty (), "Unknown routing strategy: " << name);
+  std::string typeName = name;
+  if (name.find ("::") == std::string::npos)
+    {
+      // aodv -> ns3::AodvRoutingStrategy
+      std::string shortName = name;
+      std::transform (shortName.begin (), shortName.end (), shortName.begin (), ::tolower);
+      shortName[0] = std::toupper (shortName[0]);
+      typeName = "ns3::" + shortName + "RoutingStrategy";
+    }
+  TypeId tid;
+  NS_ABORT_MSG_UNLESS (TypeId::LookupByNameFailSafe (typeName, &tid), "Unknown routing strategy: " << name);
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  Ptr<VanetRoutingStrategy> strategy = factory.Create<VanetRoutingStrategy> ();
+  NS_ABORT_MSG_UNLESS (strategy, typeName << " is not a VanetRoutingStrategy");
+  return strategy;
+}
+
+void
+VanetRoutingStrategy::InstallInfrastructure (VanetScenario &scenario)
+{
+}
+
+void
+VanetRoutingStrategy::Report (std::ostream &os)
+{
+}
+
+VanetScenario::VanetScenario (const ScenarioConfig &config)
+  : m_config (config),
+    m_strategy (0),
+    m_rsuGrid (RSU_GRID_CELL),
+    m_culled (0),
+    m_flowMonitor (0)
+{
+  m_headingRandom = CreateObject<UniformRandomVariable> ();
+  m_headingRandom->SetStream (5);
+}
+
+const ScenarioConfig &
+VanetScenario::GetConfig (void) const
+{
+  return m_config;
+}
+
+Ptr<VanetRoutingStrategy>
+VanetScenario::GetStrategy (void) const
+{
+  return m_strategy;
+}
+
+NodeContainer
+VanetScenario::GetVehicles (void) const
+{
+  return m_vehicles;
+}
+
+NodeContainer
+VanetScenario::GetRsus (void) const
+{
+  return m_rsus;
+}
+
+const std::vector<Vector> &
+VanetScenario::GetRsuPositions (void) const
+{
+  return m_rsuPositions;
+}
+
+Ipv4Address
+VanetScenario::GetVehicleAddress (uint32_t i) const
+{
+  return m_wirelessInterfaces.GetAddress (i);
+}
+
+Ipv4Address
+VanetScenario::GetRsuAddress (uint32_t i) const
+{
+  return m_wirelessInterfaces.GetAddress (m_vehicles.GetN () + i);
+}
+
+InternetStackHelper &
+VanetScenario::GetInternet (void)
+{
+  return m_internet;
+}
+
+FleetMobility &
+VanetScenario::GetFleet (void)
+{
+  return m_fleet;
+}
+
+MetricsEngine &
+VanetScenario::GetMetrics (void)
+{
+  return m_metrics;
+}
+
+ProbeRegistry *
+VanetScenario::GetProbeRegistry (void)
+{
+  return m_config.useProbes ? &m_probes : 0;
+}
+
+void
+VanetScenario::AddServer (Ptr<Node> server, Ipv4Address address)
+{
+  m_servers.Add (server);
+  m_serverAddresses.push_back (address);
+}
+
+void
+VanetScenario::Build (void)
+{
+  if (m_config.profile)
+    {
+      // Đặt trước khi tạo node để đo cả các sự kiện khởi tạo
+      Simulator::SetScheduler (ObjectFactory ("ns3::ProfilingScheduler"));
+    }
+  m_strategy = VanetRoutingStrategy::CreateByName (m_config.routing);
+  MyApp::SetPacketReuse (m_config.packetReuse);
+  m_metrics.SetMode (m_config.metricsMode);
+  m_metrics.SetWindow (Seconds (m_config.metricsWindow));
+  if (m_config.traffic == "v2x")
+    {
+      // Lớp lưu lượng để tính phân vị độ trễ riêng: V2I tới server, V2V giữa các xe
+      m_metrics.AddTrafficClass ("V2I", V2I_PORT);
+      m_metrics.AddTrafficClass ("V2V", V2V_PORT);
+      if (m_config.downlink)
+        {
+          m_metrics.AddTrafficClass ("V2I-DL", V2I_DOWN_PORT);
+        }
+    }
+
+  // Khi fork, mỗi tiến trình con tự mở file của mình
+  if (m_config.forks == 0)
+    {
+      NS_ABORT_MSG_UNLESS (m_results.Open (m_config.outputFile), "Cannot open " << m_config.outputFile);
+    }
+  m_console.OpenStdout ();
+  if (!m_config.flowTrace.empty ())
+    {
+      if (m_config.forks == 0)
+        {
+          NS_ABORT_MSG_UNLESS (m_flowTrace.Open (m_config.flowTrace), "Cannot open " << m_config.flowTrace);
+        }
+      else
+        {
+          m_flowTrace.Enable ();
+        }
+      m_metrics.SetTrace (&m_flowTrace);
+    }
+  std::ostringstream header;
+  header << "Time,Throughput,Avg Delay,PDR,"
+         << "Delay P50,Delay P95,Delay P99,Delay Max,"
+         << "Jitter P50,Jitter P95,Jitter P99,Jitter Max";
+  for (uint32_t c = 0; c < m_metrics.GetTrafficClassCount (); c++)
+    {
+      const std::string &name = m_metrics.GetTrafficClassName (c);
+      header << "," << name << " Delay P50," << name << " Delay P95,"
+             << name << " Delay P99," << name << " Delay Max,"
+             << name << " Jitter P50," << name << " Jitter P95,"
+             << name << " Jitter P99," << name << " Jitter Max";
+    }
+  header << "\n";
+  WriteCsv (header.str ());
+
+  BuildNodes ();
+  if (m_config.mobility == "rsu")
+    {
+      BuildRsuMobility ();
+    }
+  else
+    {
+      BuildRandomMobility ();
+    }
+  BuildWireless ();
+  m_strategy->InstallInfrastructure (*this);
+
+  // Khi fork, lưu lượng được tạo trong từng tiến trình con sau giai đoạn khởi động
+  if (m_config.forks == 0)
+    {
+      BuildTraffic ();
+    }
+
+  if (!m_config.animFile.empty ())
+    {
+      if (m_config.forks == 0)
+        {
+          SetupAnimation ();
+        }
+      else
+        {
+          std::cout << "NetAnim bị tắt khi dùng Forks" << std::endl;
+        }
+    }
+  SetupMetrics ();
+}
+
+void
+VanetScenario::SetupAnimation (void)
+{
+  NS_ABORT_MSG_UNLESS (m_anim.Open (m_config.animFile), "Cannot open " << m_config.animFile);
+  double stop = m_config.animStop > 0 ? m_config.animStop : m_config.simTime;
+  m_anim.SetWindow (Seconds (m_config.animStart), Seconds (stop));
+  m_anim.SetPacketSampling (m_config.animSampling);
+  m_anim.SetMaxNodes (m_config.animMaxNodes);
+  m_anim.SetPositionInterval (Seconds (m_config.animPositionInterval));
+  m_anim.SetArea (m_config.areaSize);
+
+  // Khi giới hạn số node: giữ RSU và hạ tầng (switch, controller, server) trước, xe sau
+  NodeContainer nodes (m_rsus);
+  for (uint32_t i = 0; i < NodeList::GetNNodes (); i++)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      if (node->GetId () >= m_vehicles.GetN () + m_rsus.GetN ())
+        {
+          nodes.Add (node);
+        }
+    }
+  nodes.Add (m_vehicles);
+  m_anim.Install (nodes);
+}
+
+void
+VanetScenario::BuildNodes (void)
+{
+  m_vehicles.Create (m_config.numVehicles);
+  m_rsus.Create (m_config.numRsus);
+
+  m_strategy->ConfigureInternet (m_internet);
+  m_internet.Install (m_vehicles);
+  m_internet.Install (m_rsus);
+
+  // line: RSU đặt đều trên đường ngang giữa vùng mô phỏng
+  // grid: lưới cols x rows phủ cả vùng, đánh số theo hàng để các RSU liền số
+  // nằm cạnh nhau (backhaul gom RSU liền số vào cùng switch)
+  uint32_t cols = m_config.numRsus;
+  uint32_t rows = 1;
+  if (m_config.rsuLayout == "grid" && m_config.numRsus > 0)
+    {
+      cols = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (m_config.numRsus))));
+      rows = (m_config.numRsus + cols - 1) / cols;
+    }
+  for (uint32_t r = 0; r < m_config.numRsus; r++)
+    {
+      double x = m_config.areaSize * (2 * (r % cols) + 1) / (2 * cols);
+      double y = m_config.areaSize * (2 * (r / cols) + 1) / (2 * rows);
+      Vector pos (x, y, 0.0);
+      m_rsuPositions.push_back (pos);
+      m_rsuGrid.Insert (r, pos);
+    }
+  MobilityHelper mobilityRsu;
+  mobilityRsu.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  Ptr<ListPositionAllocator> rsuAlloc = CreateObject<ListPositionAllocator> ();
+  for (const Vector &pos : m_rsuPositions)
+    {
+      rsuAlloc->Add (pos);
+    }
+  mobilityRsu.SetPositionAllocator (rsuAlloc);
+  mobilityRsu.Install (m_rsus);
+}
+
+void
+VanetScenario::BuildRandomMobility (void)
+{
+  // Vị trí ban đầu ngẫu nhiên trong vùng mô phỏng
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  UniformRandomVariable randomX;
+  randomX.SetStream (1);
+  UniformRandomVariable randomY;
+  randomY.SetStream (2);
+  for (uint32_t i = 0; i < m_config.numVehicles; i++)
+    {
+      positionAlloc->Add (Vector (randomX.GetValue (0, m_config.areaSize), randomY.GetValue (0, m_config.areaSize), 0));
+    }
+  m_fleet.Install (m_vehicles, positionAlloc);
+  AssignHeadings ();
+}
+
+void
+VanetScenario::BuildRsuMobility (void)
+{
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  UniformRandomVariable randomX;
+  randomX.SetStream (1);
+  UniformRandomVariable randomY;
+  randomY.SetStream (2);
+  UniformRandomVariable rsuSelector;
+  rsuSelector.SetStream (4);
+
+  // Mỗi xe xuất hiện cách một RSU chọn ngẫu nhiên 25-125m
+  uint32_t lastRsu = m_config.numRsus - 1;
+  for (uint32_t i = 0; i < m_config.numVehicles; i++)
+    {
+      Vector rsuPos = m_rsuPositions[rsuSelector.GetInteger (0, lastRsu)];
+      double angle = randomX.GetValue (0, 2 * M_PI);
+      double distance = randomY.GetValue (25, 125);
+      double xPos = std::max (0.0, std::min (m_config.areaSize, rsuPos.x + distance * std::cos (angle)));
+      double yPos = std::max (0.0, std::min (m_config.areaSize, rsuPos.y + distance * std::sin (angle)));
+      positionAlloc->Add (Vector (xPos, yPos, 0));
+    }
+  m_fleet.Install (m_vehicles, positionAlloc);
+  AssignHeadings ();
+}
+
+void
+VanetScenario::AssignHeadings (void)
+{
+  if (m_config.mobility == "random")
+    {
+      // Hướng ngẫu nhiên với vận tốc cố định, xe 0 đứng yên
+      UniformRandomVariable randomAngle;
+      randomAngle.SetStream (3);
+      for (uint32_t i = 1; i < m_config.numVehicles; i++)
+        {
+          double angle = randomAngle.GetValue (0, 2 * M_PI);
+          m_fleet.SetVelocity (i, Vector (m_config.speed * std::cos (angle), m_config.speed * std::sin (angle), 0));
+        }
+      return;
+    }
+
+  // 70% xe hướng về RSU gần nhất, còn lại về một RSU ngẫu nhiên
+  uint32_t lastRsu = m_config.numRsus - 1;
+  UniformRandomVariable randomRsu;
+  randomRsu.SetStream (3);
+  for (uint32_t i = 0; i < m_config.numVehicles; i++)
+    {
+      Vector position = m_fleet.GetPosition (i);
+      Vector target;
+      if (randomRsu.GetValue (0, 1) < 0.7)
+        {
+          target = m_rsuPositions[m_rsuGrid.Nearest (position)];
+        }
+      else
+        {
+          target = m_rsuPositions[randomRsu.GetInteger (0, lastRsu)];
+        }
+      m_fleet.SetVelocity (i, CalculateVelocityTowardsRsu (position, target, m_config.speed, *m_headingRandom));
+    }
+}
+
+void
+VanetScenario::BuildWireless (void)
+{
+  bool is80211p = m_config.radio == "80211p";
+
+  YansWifiChannelHelper channel;
+  channel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  Ptr<PropagationLossModel> exactLoss;
+  if (is80211p)
+    {
+      // Khoảng cách ngắn: hệ số suy giảm 3.5, suy hao tham chiếu 46 dB
+      exactLoss = CreateObject<LogDistancePropagationLossModel> ();
+      exactLoss->SetAttribute ("Exponent", DoubleValue (3.5));
+      exactLoss->SetAttribute ("ReferenceDistance", DoubleValue (1.0));
+      exactLoss->SetAttribute ("ReferenceLoss", DoubleValue (46.0));
+    }
+  else
+    {
+      exactLoss = CreateObject<ThreeLogDistancePropagationLossModel> ();
+    }
+  if (m_config.cachedLoss)
+    {
+      // Tra bảng suy hao theo khoảng cách lượng tử hóa thay vì tính log10 mỗi lần nhận
+      channel.AddPropagationLoss ("ns3::CachedPropagationLossModel",
+                                  "Model", PointerValue (exactLoss),
+                                  "MaxErrorDb", DoubleValue (m_config.lossErrorDb));
+      if (m_config.lossReport)
+        {
+          std::ostringstream out;
+          CachedPropagationLossModel::PrintAccuracyReport (exactLoss, m_config.lossErrorDb, out);
+          m_console.Write (out.str ());
+        }
+    }
+  else if (is80211p)
+    {
+      channel.AddPropagationLoss ("ns3::LogDistancePropagationLossModel",
+                                  "Exponent", DoubleValue (3.5),
+                                  "ReferenceDistance", DoubleValue (1.0),
+                                  "ReferenceLoss", DoubleValue (46.0));
+    }
+  else
+    {
+      channel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
+    }
+
+  CulledYansWifiPhyHelper phy;
+  if (m_config.culledChannel)
+    {
+      // Kênh bỏ qua các PHY ngoài phạm vi giải mã, khung tin nhận được không đổi
+      m_culled = CreateCulledChannel (channel);
+      phy.EnableCulling ();
+      phy.SetChannel (m_culled);
+    }
+  else
+    {
+      phy.SetChannel (channel.Create ());
+    }
+  phy.SetPcapDataLinkType (WifiPhyHelper::DLT_IEEE802_11);
+
+  WifiMacHelper mac;
+  WifiHelper wifi;
+  if (is80211p)
+    {
+      phy.Set ("TxPowerStart", DoubleValue (16.0));
+      phy.Set ("TxPowerEnd", DoubleValue (16.0));
+      phy.Set ("TxGain", DoubleValue (0.0));
+      phy.Set ("RxGain", DoubleValue (0.0));
+      phy.Set ("RxSensitivity", DoubleValue (-80.0));
+      mac.SetType ("ns3::AdhocWifiMac", "QosSupported", BooleanValue (true));
+      wifi.SetStandard (WIFI_STANDARD_80211p);
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue ("OfdmRate12MbpsBW10MHz"),
+                                    "ControlMode", StringValue ("OfdmRate6MbpsBW10MHz"));
+    }
+  else
+    {
+      phy.Set ("TxPowerStart", DoubleValue (14));
+      phy.Set ("TxPowerEnd", DoubleValue (14));
+      mac.SetType ("ns3::AdhocWifiMac");
+      wifi.SetStandard (WIFI_STANDARD_80211b);
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue (m_config.phyMode),
+                                    "ControlMode", StringValue (m_config.phyMode));
+    }
+
+  NetDeviceContainer vehDevices = wifi.Install (phy, mac, m_vehicles);
+  NetDeviceContainer rsuDevices = wifi.Install (phy, mac, m_rsus);
+
+  // Một dải mạng IP duy nhất cho tất cả các xe và RSU, /16 để vượt 254 node
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+  m_wirelessInterfaces.Add (ipv4.Assign (vehDevices));
+  m_wirelessInterfaces.Add (ipv4.Assign (rsuDevices));
+
+  if (m_config.captureBytes > 0)
+    {
+      m_capture.SetByteBudget (m_config.captureBytes);
+      m_capture.SetPrefix (m_config.capturePrefix);
+      m_capture.Install (vehDevices);
+      m_capture.Install (rsuDevices);
+    }
+}
+
+void
+VanetScenario::BuildTraffic (void)
+{
+  if (m_config.traffic == "v2x")
+    {
+      BuildV2xTraffic ();
+    }
+  else
+    {
+      BuildRandomTraffic ();
+    }
+}
+
+Time
+VanetScenario::At (double t) const
+{
+  return Seconds (std::max (0.0, t - Simulator::Now ().GetSeconds ()));
+}
+
+void
+VanetScenario::BuildRandomTraffic (void)
+{
+  ProbeRegistry *registry = GetProbeRegistry ();
+  Time stop = At (m_config.trafficStop);
+
+  // Sink trên tất cả các xe
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), V2I_PORT));
+  ApplicationContainer sinkApps = registry ? InstallProbeSinks (m_vehicles, V2I_PORT, registry) : sinkHelper.Install (m_vehicles);
+  sinkApps.Start (At (0.));
+  sinkApps.Stop (At (m_config.simTime));
+
+  // Flow từ n0 đến n9
+  Ptr<Socket> directSocket = Socket::CreateSocket (m_vehicles.Get (0), UdpSocketFactory::GetTypeId ());
+  Address directAddress (InetSocketAddress (GetVehicleAddress (9), V2I_PORT));
+  Ptr<MyApp> directApp = CreateSenderApp (registry, GetVehicleAddress (0), GetVehicleAddress (9), V2I_PORT);
+  directApp->Setup (directSocket, directAddress, 1024, 3000, DataRate (GetDirectRate ()));
+  m_vehicles.Get (0)->AddApplication (directApp);
+  directApp->SetStartTime (At (1.));
+  directApp->SetStopTime (stop);
+
+  // Các xe 1..9 gửi tới một xe ngẫu nhiên khác
+  UniformRandomVariable random;
+  random.SetStream (10);
+  for (uint32_t i = 1; i < 10; i++)
+    {
+      uint32_t dest;
+      do
+        {
+          dest = random.GetInteger (0, m_config.numVehicles - 1);
+        }
+      while (dest == i);
+
+      Ptr<Socket> socket = Socket::CreateSocket (m_vehicles.Get (i), UdpSocketFactory::GetTypeId ());
+      Address destAddress (InetSocketAddress (GetVehicleAddress (dest), V2I_PORT));
+      Ptr<MyApp> app = CreateSenderApp (registry, GetVehicleAddress (i), GetVehicleAddress (dest), V2I_PORT);
+      app->Setup (socket, destAddress, 512, 3000, DataRate (m_config.dataRate));
+      m_vehicles.Get (i)->AddApplication (app);
+      app->SetStartTime (At (m_config.flowStart + m_config.flowStartStep * i));
+      app->SetStopTime (stop);
+
+      if (m_config.verbosity >= 2)
+        {
+          std::ostringstream out;
+          out << "Flow setup: Node " << i << " -> Node " << dest << "\n";
+          m_console.Write (out.str ());
+        }
+    }
+}
+
+void
+VanetScenario::BuildV2xTraffic (void)
+{
+  ProbeRegistry *registry = GetProbeRegistry ();
+  Time stop = At (m_config.trafficStop);
+
+  // V2I: 10 xe đầu gửi tới server, hoặc tới RSU gần nhất khi không có server
+  bool hasServer = m_servers.GetN () > 0;
+  NS_ABORT_MSG_IF (!hasServer && m_config.numRsus == 0, "Traffic=v2x needs a server or at least one RSU");
+  if (hasServer)
+    {
+      PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), V2I_PORT));
+      ApplicationContainer serverApps = registry ? InstallProbeSinks (m_servers, V2I_PORT, registry) : sinkHelper.Install (m_servers);
+      serverApps.Start (At (1.0));
+      serverApps.Stop (At (m_config.simTime - 1.0));
+    }
+  else
+    {
+      PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), V2I_PORT));
+      ApplicationContainer rsuApps = registry ? InstallProbeSinks (m_rsus, V2I_PORT, registry) : sinkHelper.Install (m_rsus);
+      rsuApps.Start (At (1.0));
+      rsuApps.Stop (At (m_config.simTime - 1.0));
+    }
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ipv4Address dest = hasServer ? m_serverAddresses[i % m_servers.GetN ()] : GetRsuAddress (m_rsuGrid.Nearest (m_fleet.GetPosition (i)));
+      Ptr<Socket> socket = Socket::CreateSocket (m_vehicles.Get (i), UdpSocketFactory::GetTypeId ());
+      Address destAddress (InetSocketAddress (dest, V2I_PORT));
+      Ptr<MyApp> app = CreateSenderApp (registry, GetVehicleAddress (i), dest, V2I_PORT);
+      app->Setup (socket, destAddress, 1024, 3000, DataRate (m_config.dataRate));
+      m_vehicles.Get (i)->AddApplication (app);
+      app->SetStartTime (At (2.0 + i * 0.1));
+      app->SetStopTime (stop);
+    }
+
+  // Chiều xuống: server gửi tới từng xe V2I, switch chọn RSU theo vị trí xe
+  if (m_config.downlink && hasServer)
+    {
+      NodeContainer receivers;
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          receivers.Add (m_vehicles.Get (i));
+        }
+      PacketSinkHelper downSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), V2I_DOWN_PORT));
+      ApplicationContainer downSinks = registry ? InstallProbeSinks (receivers, V2I_DOWN_PORT, registry) : downSinkHelper.Install (receivers);
+      downSinks.Start (At (1.0));
+      downSinks.Stop (At (m_config.simTime - 1.0));
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          // Cùng server với chiều lên của xe
+          uint32_t server = i % m_servers.GetN ();
+          Ptr<Socket> socket = Socket::CreateSocket (m_servers.Get (server), UdpSocketFactory::GetTypeId ());
+          Address destAddress (InetSocketAddress (GetVehicleAddress (i), V2I_DOWN_PORT));
+          Ptr<MyApp> app = CreateSenderApp (registry, m_serverAddresses[server], GetVehicleAddress (i), V2I_DOWN_PORT);
+          app->Setup (socket, destAddress, 1024, 3000, DataRate (m_config.dataRate));
+          m_servers.Get (server)->AddApplication (app);
+          app->SetStartTime (At (2.05 + i * 0.1));
+          app->SetStopTime (stop);
+        }
+    }
+
+  // Sink V2V trên tất cả các xe
+  PacketSinkHelper directSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), V2V_PORT));
+  ApplicationContainer directSinkApp = registry ? InstallProbeSinks (m_vehicles, V2V_PORT, registry) : directSinkHelper.Install (m_vehicles);
+  directSinkApp.Start (At (1.0));
+  directSinkApp.Stop (stop);
+
+  // Flow trực tiếp n0 -> n9
+  Ptr<Socket> directSocket = Socket::CreateSocket (m_vehicles.Get (0), UdpSocketFactory::GetTypeId ());
+  Address directAddress (InetSocketAddress (GetVehicleAddress (9), V2V_PORT));
+  Ptr<MyApp> directApp = CreateSenderApp (registry, GetVehicleAddress (0), GetVehicleAddress (9), V2V_PORT);
+  directApp->Setup (directSocket, directAddress, 1024, 10000, DataRate (GetDirectRate ()));
+  m_vehicles.Get (0)->AddApplication (directApp);
+  directApp->SetStartTime (At (2.0));
+  directApp->SetStopTime (stop);
+  if (m_config.verbosity >= 2)
+    {
+      m_console.Write ("Direct flow setup: Vehicle 0 -> Vehicle 9\n");
+    }
+
+  // V2V giữa các xe gần nhau, tìm qua lưới không gian
+  SpatialGrid vehGrid (V2V_FLOW_DISTANCE);
+  std::vector<Vector> positions;
+  m_fleet.GetPositions (positions);
+  for (uint32_t i = 0; i < positions.size (); i++)
+    {
+      vehGrid.Insert (i, positions[i]);
+    }
+  std::vector<uint32_t> neighbors;
+
+  for (uint32_t i = 0; i < m_vehicles.GetN (); i++)
+    {
+      // Một ứng dụng V2V cho mỗi xe: một socket, một timer, danh sách đích
+      Ptr<MultiDestApp> v2vApp;
+      double v2vStart = 0.0;
+      if (m_config.v2vMode != "pair")
+        {
+          v2vApp = CreateObject<MultiDestApp> ();
+          v2vApp->SetProbeRegistry (registry);
+        }
+
+      vehGrid.QueryRadius (positions[i], V2V_FLOW_DISTANCE, neighbors);
+      for (uint32_t j : neighbors)
+        {
+          if (i == j)
+            {
+              continue;
+            }
+          double distance = CalculateDistance (positions[i], positions[j]);
+          Address receiverAddress (InetSocketAddress (GetVehicleAddress (j), V2V_PORT));
+          if (m_config.verbosity >= 2)
+            {
+              std::ostringstream out;
+              out << "Flow setup: Vehicle " << i << " -> Vehicle " << j << ", Distance: " << distance << "m\n";
+              m_console.Write (out.str ());
+            }
+
+          if (v2vApp)
+            {
+              FlowId probeId = registry ? registry->AddFlow (GetVehicleAddress (i), GetVehicleAddress (j), V2V_PORT) : 0;
+              // j tăng dần nên đích đầu tiên có thời điểm bắt đầu sớm nhất; các
+              // đích khác giữ thời điểm bắt đầu của cặp như ở chế độ pair
+              if (v2vApp->GetNDestinations () == 0)
+                {
+                  v2vStart = 5.0 + 0.02 * i * j;
+                }
+              v2vApp->AddDestination (receiverAddress, Seconds (5.0 + 0.02 * i * j - v2vStart), probeId);
+              continue;
+            }
+
+          Ptr<Socket> socket = Socket::CreateSocket (m_vehicles.Get (i), UdpSocketFactory::GetTypeId ());
+          Ptr<MyApp> app = CreateSenderApp (registry, GetVehicleAddress (i), GetVehicleAddress (j), V2V_PORT);
+          app->Setup (socket, receiverAddress, 512, 1000, DataRate (m_config.dataRate));
+          m_vehicles.Get (i)->AddApplication (app);
+          app->SetStartTime (At (5.0 + 0.02 * i * j));
+          app->SetStopTime (stop);
+        }
+
+      if (v2vApp && v2vApp->GetNDestinations () > 0)
+        {
+          Ptr<Socket> socket = Socket::CreateSocket (m_vehicles.Get (i), UdpSocketFactory::GetTypeId ());
+          v2vApp->Setup (socket, 512, 1000, DataRate (m_config.dataRate),
+                         m_config.v2vMode == "fanout" ? MultiDestApp::FANOUT : MultiDestApp::ROUND_ROBIN);
+          m_vehicles.Get (i)->AddApplication (v2vApp);
+          v2vApp->SetStartTime (At (v2vStart));
+          v2vApp->SetStopTime (stop);
+        }
+    }
+}
+
+std::string
+VanetScenario::GetDirectRate (void) const
+{
+  return m_config.directRate.empty () ? m_config.dataRate : m_config.directRate;
+}
+
+void
+VanetScenario::SetupMetrics (void)
+{
+  if (m_config.enableFlowMonitor)
+    {
+      m_flowMonitor = m_flowHelper.InstallAll ();
+      m_flowMonitor->SetAttribute ("DelayBinWidth", DoubleValue (0.001));
+      m_flowMonitor->SetAttribute ("JitterBinWidth", DoubleValue (0.001));
+      m_flowMonitor->SetAttribute ("PacketSizeBinWidth", DoubleValue (20));
+      m_metrics.Setup (m_flowMonitor, DynamicCast<Ipv4FlowClassifier> (m_flowHelper.GetClassifier ()));
+    }
+  // Probe tầng ứng dụng cho đủ thông số ngay cả khi tắt Flow Monitor
+  if (m_config.useProbes)
+    {
+      m_metrics.Setup (&m_probes);
+    }
+}
+
+void
+VanetScenario::LogMetrics (void)
+{
+  // Chỉ cập nhật các flow có bộ đếm thay đổi kể từ lần lấy mẫu trước
+  m_metrics.Sample ();
+  if (m_flowTrace.IsEnabled ())
+    {
+      m_flowTrace.Flush (Simulator::Now ());
+    }
+  if (m_capture.IsInstalled ())
+    {
+      CheckCapture ();
+    }
+  double currentTime = Simulator::Now ().GetSeconds ();
+
+  double avgThroughput = m_metrics.GetAvgThroughput ();
+  double avgDelay = m_metrics.GetAvgDelay ();
+  double avgPdr = m_metrics.GetAvgPdr ();
+  Percentiles delayPct = m_metrics.GetDelayPercentiles ();
+  Percentiles jitterPct = m_metrics.GetJitterPercentiles ();
+
+  // Định dạng trong bộ nhớ, ResultSink ghi ra ở luồng nền
+  std::ostringstream out;
+  if (m_config.verbosity >= 2)
+    {
+      // Danh sách flow trong 10 giây đầu để xác định các flow hiện có
+      if (currentTime <= 10.0)
+        {
+          out << "========== Thời điểm: " << currentTime << "s, Số lượng flow: " << m_metrics.GetFlowCount () << " ==========\n";
+          for (FlowId id = 1; id <= m_metrics.GetMaxFlowId (); id++)
+            {
+              const FlowEntry &f = m_metrics.GetFlow (id);
+              if (f.known)
+                {
+                  out << "Flow " << id << " (" << f.tuple.sourceAddress << " -> " << f.tuple.destinationAddress << ")\n";
+                }
+            }
+        }
+
+      // Chi tiết các flow vừa thay đổi (flow không đổi vẫn giữ giá trị cũ)
+      for (FlowId id : m_metrics.GetChangedFlows ())
+        {
+          const FlowEntry &f = m_metrics.GetFlow (id);
+          if (f.valid)
+            {
+              out << "Flow " << id << " (" << f.tuple.sourceAddress << " -> " << f.tuple.destinationAddress << "):\n"
+                  << "  Throughput: " << f.throughput << " Kbps\n"
+                  << "  Avg Delay:  " << f.avgDelay << " s\n"
+                  << "  PDR:        " << f.pdr << " %\n";
+            }
+        }
+    }
+  if (m_config.verbosity >= 1)
+    {
+      out << "========== THÔNG SỐ TRUNG BÌNH TẤT CẢ CÁC FLOW (" << m_strategy->GetName () << ") ==========\n"
+          << "Thời điểm: " << currentTime << "s\n"
+          << "Số flow hợp lệ: " << m_metrics.GetValidFlowCount () << "\n"
+          << "Throughput trung bình: " << avgThroughput << " Kbps\n"
+          << "Delay trung bình: " << avgDelay << " s\n"
+          << "PDR trung bình: " << avgPdr << " %\n"
+          << "Delay p50/p95/p99/max: " << delayPct.p50 << " / " << delayPct.p95
+          << " / " << delayPct.p99 << " / " << delayPct.max << " s\n";
+      m_console.Write (out.str ());
+    }
+
+  std::ostringstream csv;
+  csv << currentTime << "," << avgThroughput << "," << avgDelay << "," << avgPdr
+      << "," << delayPct << "," << jitterPct;
+  for (uint32_t c = 0; c < m_metrics.GetTrafficClassCount (); c++)
+    {
+      csv << "," << m_metrics.GetClassDelayPercentiles (c) << "," << m_metrics.GetClassJitterPercentiles (c);
+    }
+  csv << "\n";
+  WriteCsv (csv.str ());
+
+  if (currentTime < m_config.simTime - 1.0)
+    {
+      Simulator::Schedule (m_metrics.GetWindow (), &VanetScenario::LogMetrics, this);
+    }
+}
+
+void
+VanetScenario::CheckCapture (void)
+{
+  if (m_capture.GetDumpCount () >= m_config.captureMaxDumps || m_metrics.GetWindowTxPackets () == 0)
+    {
+      return;
+    }
+  double pdr = m_metrics.GetWindowPdr ();
+  double delay = m_metrics.GetWindowDelay ();
+  bool lowPdr = m_config.captureMinPdr > 0 && pdr < m_config.captureMinPdr;
+  bool highDelay = m_config.captureMaxDelay > 0 && delay > m_config.captureMaxDelay;
+  if (!lowPdr && !highDelay)
+    {
+      return;
+    }
+  uint32_t dump = m_capture.GetDumpCount ();
+  uint32_t files = m_capture.Dump ();
+  std::ostringstream out;
+  out << "Ghi pcap lần " << dump << " lúc " << Simulator::Now ().GetSeconds () << " s ("
+      << files << " file): PDR cửa sổ " << pdr << " %, delay cửa sổ " << delay << " s\n";
+  m_console.Write (out.str ());
+}
+
+void
+VanetScenario::StopMovement (void)
+{
+  m_fleet.StopAll ();
+}
+
+void
+VanetScenario::WriteCsv (const std::string &text)
+{
+  if (m_results.IsOpen ())
+    {
+      m_results.Write (text);
+    }
+  else
+    {
+      m_csvHead << text;
+    }
+}
+
+void
+VanetScenario::Run (void)
+{
+  Simulator::Schedule (m_metrics.GetWindow (), &VanetScenario::LogMetrics, this);
+  Simulator::Schedule (Seconds (m_config.moveTime), &VanetScenario::StopMovement, this);
+  if (m_config.forks > 0)
+    {
+      RunWarmStart ();
+      return;
+    }
+  Simulator::Stop (Seconds (m_config.simTime));
+  RunToEnd ();
+}
+
+void
+VanetScenario::RunToEnd (void)
+{
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double wallSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - wallStart).count ();
+  if (ProfilingScheduler::GetInstance ())
+    {
+      ProfilingScheduler::GetInstance ()->StopAccounting ();
+    }
+  // In hết phần còn đệm trước các dòng tổng kết
+  m_console.Close ();
+  m_results.Close ();
+  m_flowTrace.Close ();
+  m_anim.Close ();
+
+  // Đo hiệu năng mô phỏng để so sánh các cấu hình
+  uint64_t eventCount = Simulator::GetEventCount ();
+  std::cout << "Thời gian chạy: " << wallSeconds << " s, số sự kiện: " << eventCount
+            << ", sự kiện/giây: " << (wallSeconds > 0 ? eventCount / wallSeconds : 0.0) << std::endl;
+  // ru_maxrss tính theo KB trên Linux
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  std::cout << "Bộ nhớ đỉnh: " << usage.ru_maxrss << " KB" << std::endl;
+  if (m_culled)
+    {
+      std::cout << "Kênh lọc: " << m_culled->GetScheduledReceptions () << " lần nhận được lập lịch, "
+                << m_culled->GetSkippedReceptions () << " lần bỏ qua, phạm vi "
+                << m_culled->GetMaxRange () << " m" << std::endl;
+    }
+  if (m_config.useProbes)
+    {
+      std::cout << "Số gói đến sai thứ tự: " << m_probes.GetTotalReordered () << std::endl;
+    }
+  if (m_config.enableFlowMonitor || m_config.useProbes)
+    {
+      m_metrics.PrintSetupLatency (std::cout, m_config.verbosity >= 2);
+    }
+  if (!m_config.animFile.empty ())
+    {
+      std::cout << "NetAnim: " << m_anim.GetPacketCount () << " gói, "
+                << m_anim.GetPositionCount () << " cập nhật vị trí" << std::endl;
+    }
+  m_strategy->Report (std::cout);
+  if (ProfilingScheduler::GetInstance ())
+    {
+      ProfilingScheduler::GetInstance ()->PrintProfile (std::cout);
+    }
+
+  Simulator::Destroy ();
+}
+
+void
+VanetScenario::RunWarmStart (void)
+{
+  // Giai đoạn chung: định tuyến hội tụ, xe di chuyển, chưa có lưu lượng.
+  // Các tiến trình con thừa hưởng trạng thái này thay vì mô phỏng lại từ đầu.
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now ();
+  Simulator::Stop (Seconds (m_config.warmupTime));
+  Simulator::Run ();
+  double wallSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - wallStart).count ();
+  if (ProfilingScheduler::GetInstance ())
+    {
+      // Thời gian fork và chờ không thuộc sự kiện cuối của giai đoạn khởi động
+      ProfilingScheduler::GetInstance ()->StopAccounting ();
+    }
+  // Luồng nền không được sao chép sang tiến trình con
+  m_console.Close ();
+
+  uint64_t baseRun = RngSeedManager::GetRun ();
+  uint32_t jobs = m_config.forkJobs > 0 ? m_config.forkJobs : m_config.forks;
+  std::cout << "Khởi động tới " << m_config.warmupTime << " s mất " << wallSeconds << " s, tách "
+            << m_config.forks << " tiến trình (RngRun " << baseRun << ".." << baseRun + m_config.forks - 1
+            << ")" << std::endl;
+
+  uint32_t running = 0;
+  uint32_t failed = 0;
+  for (uint32_t k = 0; k < m_config.forks; k++)
+    {
+      // Chờ một tiến trình con kết thúc khi đã đủ số chạy cùng lúc
+      int status;
+      if (running == jobs && wait (&status) > 0)
+        {
+          running--;
+          failed += !(WIFEXITED (status) && WEXITSTATUS (status) == 0);
+        }
+      std::cout.flush ();
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "fork() failed");
+      if (pid == 0)
+        {
+          RunChild (baseRun + k);
+          std::cout.flush ();
+          _exit (0);
+        }
+      running++;
+    }
+  int status;
+  while (running > 0 && wait (&status) > 0)
+    {
+      running--;
+      failed += !(WIFEXITED (status) && WEXITSTATUS (status) == 0);
+    }
+  std::cout << "Xong " << m_config.forks - failed << "/" << m_config.forks << " tiến trình con" << std::endl;
+  Simulator::Destroy ();
+  NS_ABORT_MSG_IF (failed > 0, failed << " forked replications failed");
+}
+
+// results.csv -> results-run<N>.csv
+std::string
+RunFileName (const std::string &file, uint64_t run)
+{
+  std::string::size_type dot = file.rfind ('.');
+  std::string suffix = "-run" + std::to_string (run);
+  return dot == std::string::npos ? file + suffix : file.substr (0, dot) + suffix + file.substr (dot);
+}
+
+void
+VanetScenario::RunChild (uint64_t run)
+{
+  // Các biến ngẫu nhiên tạo sau SetRun lấy dãy số của lần chạy mới.
+  // Vị trí tại thời điểm fork là chung cho mọi tiến trình con.
+  RngSeedManager::SetRun (run);
+  m_headingRandom = CreateObject<UniformRandomVariable> ();
+  m_headingRandom->SetStream (5);
+  if (Simulator::Now ().GetSeconds () < m_config.moveTime)
+    {
+      AssignHeadings ();
+    }
+
+  std::string file = RunFileName (m_config.outputFile, run);
+  NS_ABORT_MSG_UNLESS (m_results.Open (file), "Cannot open " << file);
+  m_results.Write (m_csvHead.str ());
+  if (m_flowTrace.IsEnabled ())
+    {
+      file = RunFileName (m_config.flowTrace, run);
+      NS_ABORT_MSG_UNLESS (m_flowTrace.Open (file), "Cannot open " << file);
+    }
+  m_console.OpenStdout ();
+  m_capture.SetPrefix (RunFileName (m_config.capturePrefix, run));
+
+  BuildTraffic ();
+  Simulator::Stop (Seconds (m_config.simTime) - Simulator::Now ());
+  RunToEnd ();
+}
+
+#endif /* SCENARIO_H */
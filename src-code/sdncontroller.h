@@ -0,0 +1,381 @@
+#ifndef SDNCONTROLLER_H
+#define SDNCONTROLLER_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/ofswitch13-module.h"
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+
+// Controller chủ động cho backhaul RSU - switch - server. Controller biết trước
+// subnet nằm sau mỗi cổng của từng switch (mỗi RSU một subnet, server một
+// subnet) nên khi switch kết nối sẽ cài ngay các luật wildcard theo tiền tố IP
+// đích, cộng một luật mặc định đi lên switch cha với switch không phải gốc. Lưu
+// lượng ổn định không bao giờ lên controller: không flood, không học MAC như
+// OFSwitch13LearningController. Gói không khớp luật nào mới được gửi lên
+// (table-miss) và chỉ được đếm rồi bỏ.
+// Khi control plane được chia shard, mỗi controller chỉ quản lý switch trong
+// vùng của mình; cập nhật luật của xe từ shard khác tới qua SyncHostRoute.
+// Sau mỗi lần đổi luật của xe, controller gửi barrier tới từng switch bị ảnh
+// hưởng: barrier reply về nghĩa là luật đã được cài, độ trễ thiết lập tính từ
+// lúc sự kiện xảy ra (kể cả trễ đồng bộ giữa các shard).
+class VanetSdnController : public OFSwitch13Controller
+{
+public:
+  // Datapath id -> các cổng ra trên switch đó
+  typedef std::map<uint64_t, std::vector<uint32_t> > PortMap;
+
+  static TypeId GetTypeId (void);
+
+  VanetSdnController ();
+
+  // Gói có IP đích thuộc network/mask đi ra cổng port của switch dpId
+  void AddRoute (uint64_t dpId, Ipv4Address network, Ipv4Mask mask, uint32_t port);
+  // Gói không khớp luật theo subnet đi ra cổng port (cổng lên switch cha)
+  void SetUplink (uint64_t dpId, uint32_t port);
+  // Luật riêng cho một host (ưu tiên hơn luật theo subnet) trên các switch của
+  // đường đi tới RSU, gửi ra mọi cổng trong ports[dpId]; dùng để chuyển lưu
+  // lượng xuống của xe sang RSU mới trước khi handover. Switch có luật cũ mà
+  // không còn trong ports thì luật bị xóa. Gọi trước khi switch kết nối thì
+  // luật được cài lúc bắt tay. requested là lúc sự kiện gây ra cập nhật.
+  void SetHostRoute (Ipv4Address host, const PortMap &ports, Time requested);
+  // Như SetHostRoute, cập nhật do shard khác gửi sang
+  void SyncHostRoute (Ipv4Address host, const PortMap &ports, Time requested);
+
+  uint64_t GetFlowModCount (void) const;
+  uint64_t GetPacketInCount (void) const;
+  uint64_t GetHostRouteCount (void) const;
+  uint64_t GetSyncCount (void) const;
+  uint32_t GetSwitchCount (void) const;
+  // Độ trễ cài luật của xe (s), mỗi mẫu một switch một lần cập nhật
+  const std::vector<double> &GetSetupLatencies (void) const;
+  void Report (std::ostream &os) const;
+  // Số mẫu, trung bình, p50, p95, max (ms) của độ trễ cài luật
+  static void PrintLatencies (std::ostream &os, std::vector<double> latencies);
+
+protected:
+  virtual void HandshakeSuccessful (Ptr<const RemoteSwitch> swtch);
+  virtual ofl_err HandlePacketIn (struct ofl_msg_packet_in *msg, Ptr<const RemoteSwitch> swtch, uint32_t xid);
+  virtual ofl_err HandleBarrierReply (struct ofl_msg_header *msg, Ptr<const RemoteSwitch> swtch, uint32_t xid);
+
+private:
+  struct Route
+  {
+    Ipv4Address network;
+    Ipv4Mask    mask;
+    uint32_t    port;
+  };
+
+  struct SwitchRules
+  {
+    SwitchRules ();
+
+    std::vector<Route>  routes;
+    uint32_t            uplink;          // 0: switch gốc, không có cổng lên
+    bool                connected;
+    std::map<Ipv4Address, std::vector<uint32_t> > hosts;
+  };
+
+  // DpctlExecute kèm đếm số flow-mod gửi xuống switch
+  void FlowMod (uint64_t dpId, const std::string &command);
+  void InstallHostRoute (uint64_t dpId, Ipv4Address host, const std::vector<uint32_t> &ports);
+  void RemoveHostRoute (uint64_t dpId, Ipv4Address host);
+  void SendBarrier (uint64_t dpId, Time requested);
+
+  std::map<uint64_t, SwitchRules> m_switches;
+  std::map<Ipv4Address, PortMap>  m_hostRoutes;
+  uint64_t            m_routeCount;
+  std::map<uint32_t, Time> m_barriers;   // xid -> lúc sự kiện
+  std::vector<double> m_setupLatencies;
+  uint64_t            m_syncs;
+  uint64_t            m_hostRouteMods;
+  uint64_t            m_flowMods;
+  uint64_t            m_packetIns;
+  uint32_t            m_handshakes;
+  Time                m_installTime;     // lúc luật chủ động được cài xong
+  Time                m_firstPacketIn;
+  Time                m_lastPacketIn;
+};
+
+// Cổng điều khiển của OLSR, không cho đi qua backhaul
+const uint16_t OLSR_PORT = 698;
+
+NS_OBJECT_ENSURE_REGISTERED (VanetSdnController);
+
+TypeId
+VanetSdnController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VanetSdnController")
+    .SetParent<OFSwitch13Controller> ()
+    .SetGroupName ("Vanet")
+    .AddConstructor<VanetSdnController> ()
+  ;
+  return tid;
+}
+
+VanetSdnController::SwitchRules::SwitchRules ()
+  : uplink (0),
+    connected (false)
+{
+}
+
+VanetSdnController::VanetSdnController ()
+  : m_routeCount (0),
+    m_syncs (0),
+    m_hostRouteMods (0),
+    m_flowMods (0),
+    m_packetIns (0),
+    m_handshakes (0)
+{
+}
+
+void
+VanetSdnController::AddRoute (uint64_t dpId, Ipv4Address network, Ipv4Mask mask, uint32_t port)
+{
+  Route route;
+  route.network = network;
+  route.mask = mask;
+  route.port = port;
+  m_switches[dpId].routes.push_back (route);
+  m_routeCount++;
+}
+
+void
+VanetSdnController::SetUplink (uint64_t dpId, uint32_t port)
+{
+  m_switches[dpId].uplink = port;
+}
+
+void
+VanetSdnController::SyncHostRoute (Ipv4Address host, const PortMap &ports, Time requested)
+{
+  m_syncs++;
+  SetHostRoute (host, ports, requested);
+}
+
+void
+VanetSdnController::SetHostRoute (Ipv4Address host, const PortMap &ports, Time requested)
+{
+  PortMap &current = m_hostRoutes[host];
+  for (const auto &old : current)
+    {
+      if (ports.find (old.first) == ports.end ())
+        {
+          SwitchRules &rules = m_switches[old.first];
+          rules.hosts.erase (host);
+          if (rules.connected)
+            {
+              RemoveHostRoute (old.first, host);
+              SendBarrier (old.first, requested);
+            }
+        }
+    }
+  for (const auto &entry : ports)
+    {
+      SwitchRules &rules = m_switches[entry.first];
+      auto it = current.find (entry.first);
+      // Switch trên đoạn đường chung (gần gốc) thường giữ nguyên cổng
+      if (it != current.end () && it->second == entry.second)
+        {
+          continue;
+        }
+      rules.hosts[host] = entry.second;
+      if (rules.connected)
+        {
+          InstallHostRoute (entry.first, host, entry.second);
+          SendBarrier (entry.first, requested);
+        }
+    }
+  current = ports;
+}
+
+void
+VanetSdnController::RemoveHostRoute (uint64_t dpId, Ipv4Address host)
+{
+  std::ostringstream cmd;
+  cmd << "flow-mod cmd=dels,table=0,prio=200 eth_type=0x800,ip_dst=" << host;
+  FlowMod (dpId, cmd.str ());
+  m_hostRouteMods++;
+}
+
+void
+VanetSdnController::SendBarrier (uint64_t dpId, Time requested)
+{
+  // Switch xử lý bản tin theo thứ tự nên barrier reply về sau flow-mod vừa gửi
+  struct ofl_msg_header msg;
+  msg.type = OFPT_BARRIER_REQUEST;
+  uint32_t xid = GetNextXid ();
+  m_barriers[xid] = requested;
+  SendToSwitch (GetRemoteSwitch (dpId), &msg, xid);
+}
+
+void
+VanetSdnController::InstallHostRoute (uint64_t dpId, Ipv4Address host, const std::vector<uint32_t> &ports)
+{
+  // cmd=add ghi đè luật có cùng match và độ ưu tiên
+  std::ostringstream cmd;
+  cmd << "flow-mod cmd=add,table=0,prio=200 eth_type=0x800,ip_dst=" << host << " apply:";
+  for (uint32_t i = 0; i < ports.size (); i++)
+    {
+      cmd << (i > 0 ? "," : "") << "output=" << ports[i];
+    }
+  FlowMod (dpId, cmd.str ());
+  m_hostRouteMods++;
+}
+
+void
+VanetSdnController::FlowMod (uint64_t dpId, const std::string &command)
+{
+  DpctlExecute (dpId, command);
+  m_flowMods++;
+}
+
+void
+VanetSdnController::HandshakeSuccessful (Ptr<const RemoteSwitch> swtch)
+{
+  uint64_t dpId = swtch->GetDpId ();
+  SwitchRules &rules = m_switches[dpId];
+  rules.connected = true;
+  m_handshakes++;
+
+  // Một luật cho mỗi subnet, không phụ thuộc số xe hay số flow
+  for (const Route &route : rules.routes)
+    {
+      std::ostringstream cmd;
+      cmd << "flow-mod cmd=add,table=0,prio=100 eth_type=0x800,ip_dst=" << route.network
+          << "/" << route.mask.GetPrefixLength () << " apply:output=" << route.port;
+      FlowMod (dpId, cmd.str ());
+    }
+  // OLSR chỉ chạy trên phần vô tuyến, gói OLSR tới switch thì bỏ ngay tại switch
+  std::ostringstream olsr;
+  olsr << "flow-mod cmd=add,table=0,prio=50 eth_type=0x800,ip_proto=17,udp_dst=" << OLSR_PORT;
+  FlowMod (dpId, olsr.str ());
+  if (rules.uplink != 0)
+    {
+      std::ostringstream up;
+      up << "flow-mod cmd=add,table=0,prio=10 eth_type=0x800 apply:output=" << rules.uplink;
+      FlowMod (dpId, up.str ());
+    }
+  // Table-miss lên controller để đếm những gì luật chủ động chưa bao phủ
+  FlowMod (dpId, "flow-mod cmd=add,table=0,prio=0 apply:output=ctrl");
+  for (const auto &host : rules.hosts)
+    {
+      InstallHostRoute (dpId, host.first, host.second);
+    }
+  m_installTime = Simulator::Now ();
+}
+
+ofl_err
+VanetSdnController::HandlePacketIn (struct ofl_msg_packet_in *msg, Ptr<const RemoteSwitch> swtch, uint32_t xid)
+{
+  if (m_packetIns == 0)
+    {
+      m_firstPacketIn = Simulator::Now ();
+    }
+  m_lastPacketIn = Simulator::Now ();
+  m_packetIns++;
+  ofl_msg_free ((struct ofl_msg_header*)msg, 0);
+  return 0;
+}
+
+ofl_err
+VanetSdnController::HandleBarrierReply (struct ofl_msg_header *msg, Ptr<const RemoteSwitch> swtch, uint32_t xid)
+{
+  auto it = m_barriers.find (xid);
+  if (it != m_barriers.end ())
+    {
+      m_setupLatencies.push_back ((Simulator::Now () - it->second).GetSeconds ());
+      m_barriers.erase (it);
+    }
+  ofl_msg_free (msg, 0);
+  return 0;
+}
+
+uint64_t
+VanetSdnController::GetFlowModCount (void) const
+{
+  return m_flowMods;
+}
+
+uint64_t
+VanetSdnController::GetPacketInCount (void) const
+{
+  return m_packetIns;
+}
+
+uint64_t
+VanetSdnController::GetHostRouteCount (void) const
+{
+  return m_hostRouteMods;
+}
+
+uint64_t
+VanetSdnController::GetSyncCount (void) const
+{
+  return m_syncs;
+}
+
+uint32_t
+VanetSdnController::GetSwitchCount (void) const
+{
+  return m_switches.size ();
+}
+
+const std::vector<double> &
+VanetSdnController::GetSetupLatencies (void) const
+{
+  return m_setupLatencies;
+}
+
+void
+VanetSdnController::PrintLatencies (std::ostream &os, std::vector<double> latencies)
+{
+  os << latencies.size () << " lần cài luật";
+  if (latencies.empty ())
+    {
+      return;
+    }
+  std::sort (latencies.begin (), latencies.end ());
+  double sum = 0.0;
+  for (double l : latencies)
+    {
+      sum += l;
+    }
+  std::size_t p50 = latencies.size () / 2;
+  std::size_t p95 = std::min (latencies.size () - 1, static_cast<std::size_t> (0.95 * latencies.size ()));
+  os << ", trung bình " << sum / latencies.size () * 1000 << " ms, p50 " << latencies[p50] * 1000
+     << " ms, p95 " << latencies[p95] * 1000 << " ms, max " << latencies.back () * 1000 << " ms";
+}
+
+void
+VanetSdnController::Report (std::ostream &os) const
+{
+  os << "Controller: " << m_handshakes << " switch, " << m_routeCount << " luật định tuyến, "
+     << m_flowMods << " flow-mod (cài xong lúc " << m_installTime.GetSeconds () << " s), "
+     << m_packetIns << " packet-in, " << m_hostRouteMods << " lần cập nhật luật theo xe";
+  if (m_packetIns > 0)
+    {
+      os << " (" << m_firstPacketIn.GetSeconds () << " - " << m_lastPacketIn.GetSeconds () << " s)";
+    }
+  os << std::endl;
+  double seconds = Simulator::Now ().GetSeconds ();
+  if (seconds > 0)
+    {
+      os << "  Tải: " << m_packetIns / seconds << " packet-in/s, " << m_flowMods / seconds << " flow-mod/s, "
+         << m_syncs << " cập nhật đồng bộ từ shard khác" << std::endl;
+    }
+  os << "  Thiết lập luật theo xe: ";
+  PrintLatencies (os, m_setupLatencies);
+  os << std::endl;
+}
+
+#endif /* SDNCONTROLLER_H */
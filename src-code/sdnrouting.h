@@ -0,0 +1,513 @@
+#ifndef SDNROUTING_H
+#define SDNROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/olsr-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/ofswitch13-module.h"
+#include "scenario.h"
+#include "routing.h"
+#include "sdncontroller.h"
+#include "handover.h"
+#include "centralrouting.h"
+#include "backhaul.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+
+// Các RSU và server nối qua cây switch OpenFlow do BackhaulTopology sinh ra;
+// VanetSdnController cài sẵn luật theo tiền tố của từng cổng. Phần vô tuyến có
+// hai chế độ (WirelessRouting):
+//  - olsr: OLSR trên xe và RSU, RSU quảng bá subnet của server vào OLSR (HNA)
+//  - central: không chạy OLSR, CentralRouteController tính đường từ đồ thị kết
+//    nối và cài vào bảng định tuyến tĩnh của xe và RSU
+// Với NumControllers > 1, switch được chia cho nhiều controller theo vùng RSU,
+// mỗi shard một kênh OpenFlow riêng; luật của xe trải qua nhiều shard được
+// đồng bộ giữa các controller với trễ SyncDelay.
+// AssociationTracker dự đoán RSU kế tiếp của từng xe; luật của xe trên switch
+// được gửi kép qua RSU hiện tại và RSU kế tiếp cho tới khi handover xong.
+class SdnRoutingStrategy : public VanetRoutingStrategy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  SdnRoutingStrategy ();
+
+  virtual std::string GetName (void) const;
+  virtual void ConfigureInternet (InternetStackHelper &internet);
+  virtual void InstallInfrastructure (VanetScenario &scenario);
+  virtual void Report (std::ostream &os);
+
+private:
+  // Dựng backhaul, controller, server và phần định tuyến vô tuyến
+  void BuildInfrastructure (VanetScenario &scenario);
+  // Thêm HNA vào OLSR của node
+  void AdvertiseNetwork (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask);
+  void HandleHandover (uint32_t vehicle, int32_t from, int32_t to);
+  void HandlePrediction (uint32_t vehicle, int32_t current, int32_t next);
+  // Luật của xe qua RSU rsu (và RSU other nếu >= 0), chia cho các shard
+  void UpdateHostRoute (uint32_t vehicle, int32_t rsu, int32_t other);
+  // Cổng trên các switch từ gốc xuống RSU rsu và RSU other (-1: không có)
+  VanetSdnController::PortMap GetPorts (int32_t rsu, int32_t other) const;
+  // Khoảng cách giải mã được của radio Wi-Fi trên node, đọc từ PHY và kênh
+  static double GetRadioRange (Ptr<Node> node);
+
+  OlsrHelper               m_olsr;
+  Ipv4StaticRoutingHelper  m_static;
+  Ipv4ListRoutingHelper    m_list;
+  NodeContainer            m_controllers;
+  std::vector<Ptr<VanetSdnController> > m_shards;
+  std::vector<uint32_t>    m_switchShard;     // theo chỉ số switch của backhaul
+  std::map<uint64_t, uint32_t> m_dpShard;
+  std::vector<std::vector<VanetSdnController::PortMap> > m_vehiclePorts;  // theo xe, theo shard
+  uint64_t                 m_syncMessages;
+  double                   m_setupSeconds;    // thời gian thực dựng hạ tầng
+  uint32_t                 m_controllerCount;
+  DataRate                 m_controlRate;
+  Time                     m_controlDelay;
+  Time                     m_syncDelay;
+  BackhaulTopology         m_backhaul;
+  std::vector<uint64_t>    m_dpIds;           // theo chỉ số switch của backhaul
+  uint32_t                 m_switchFanout;
+  std::string              m_topology;
+  uint32_t                 m_serverCount;
+  DataRate                 m_backhaulRate;
+  Time                     m_backhaulDelay;
+  std::vector<Ipv4Address> m_vehicleAddresses;
+  AssociationTracker       m_tracker;
+  HandoverMonitor          m_handoverMonitor;
+  Time                     m_trackInterval;
+  Time                     m_predictionHorizon;
+  double                   m_hysteresis;
+  std::string              m_wirelessRouting;
+  double                   m_linkRange;
+  Time                     m_topologyInterval;
+  std::string              m_pathMetric;
+  Time                     m_controlHopDelay;
+  bool                     m_verifyRoutes;
+  CentralRouteController   m_central;
+  OlsrOverhead             m_olsrOverhead;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (SdnRoutingStrategy);
+
+TypeId
+SdnRoutingStrategy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SdnRoutingStrategy")
+    .SetParent<VanetRoutingStrategy> ()
+    .SetGroupName ("Vanet")
+    .AddConstructor<SdnRoutingStrategy> ()
+    .AddAttribute ("SwitchFanout", "RSUs per edge switch and switches per upper switch (0: one switch)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&SdnRoutingStrategy::m_switchFanout),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BackhaulTopology", "Switch tree (tree|fattree), fattree scales uplinks with the RSUs below",
+                   StringValue ("tree"),
+                   MakeStringAccessor (&SdnRoutingStrategy::m_topology),
+                   MakeStringChecker ())
+    .AddAttribute ("NumServers", "Number of servers on the root switch",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SdnRoutingStrategy::m_serverCount),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BackhaulRate", "Data rate of an RSU backhaul link",
+                   DataRateValue (DataRate ("100Mbps")),
+                   MakeDataRateAccessor (&SdnRoutingStrategy::m_backhaulRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("BackhaulDelay", "Delay of each backhaul link",
+                   TimeValue (MilliSeconds (2)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_backhaulDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("NumControllers", "Number of controller shards, each owning a region of switches",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SdnRoutingStrategy::m_controllerCount),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ControlChannelRate", "Data rate of the OpenFlow channel of each shard",
+                   DataRateValue (DataRate ("10Gbps")),
+                   MakeDataRateAccessor (&SdnRoutingStrategy::m_controlRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("ControlChannelDelay", "Delay of the OpenFlow channel of each shard",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_controlDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("SyncDelay", "Delay of a state update between controller shards",
+                   TimeValue (MilliSeconds (5)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_syncDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("TrackInterval", "Interval between vehicle-to-RSU association updates",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_trackInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("PredictionHorizon", "How far ahead the next RSU of a vehicle is predicted",
+                   TimeValue (Seconds (2)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_predictionHorizon),
+                   MakeTimeChecker ())
+    .AddAttribute ("HandoverHysteresis", "Distance (m) by which a new RSU must be closer before a handover",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&SdnRoutingStrategy::m_hysteresis),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("WirelessRouting", "Routing of the vehicle mesh (olsr|central)",
+                   StringValue ("olsr"),
+                   MakeStringAccessor (&SdnRoutingStrategy::m_wirelessRouting),
+                   MakeStringChecker ())
+    .AddAttribute ("LinkRange", "Link range (m) of the central controller's topology, 0 to derive it from the radio",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&SdnRoutingStrategy::m_linkRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("TopologyInterval", "Interval between topology updates of the central controller",
+                   TimeValue (MilliSeconds (500)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_topologyInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("PathMetric", "Central path selection (hops|load), load breaks hop ties by relay load",
+                   StringValue ("hops"),
+                   MakeStringAccessor (&SdnRoutingStrategy::m_pathMetric),
+                   MakeStringChecker ())
+    .AddAttribute ("ControlHopDelay", "Delay of a central route update per wireless hop",
+                   TimeValue (MilliSeconds (5)),
+                   MakeTimeAccessor (&SdnRoutingStrategy::m_controlHopDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("VerifyRoutes", "Check the central controller's trees against a full BFS after every update (slow)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SdnRoutingStrategy::m_verifyRoutes),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+SdnRoutingStrategy::SdnRoutingStrategy ()
+  : m_syncMessages (0),
+    m_setupSeconds (0.0)
+{
+}
+
+std::string
+SdnRoutingStrategy::GetName (void) const
+{
+  return "SDN";
+}
+
+void
+SdnRoutingStrategy::ConfigureInternet (InternetStackHelper &internet)
+{
+  NS_ABORT_MSG_IF (m_wirelessRouting != "olsr" && m_wirelessRouting != "central",
+                   "Unknown WirelessRouting: " << m_wirelessRouting);
+  NS_ABORT_MSG_IF (m_pathMetric != "hops" && m_pathMetric != "load", "Unknown PathMetric: " << m_pathMetric);
+  m_list.Add (m_static, 0);
+  if (m_wirelessRouting == "olsr")
+    {
+      m_list.Add (m_olsr, 10);  // OLSR có ưu tiên cao hơn
+    }
+  internet.SetRoutingHelper (m_list);
+}
+
+void
+SdnRoutingStrategy::InstallInfrastructure (VanetScenario &scenario)
+{
+  // Đo để so khả năng mở rộng theo số RSU (scale_benchmark.py)
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  BuildInfrastructure (scenario);
+  m_setupSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+void
+SdnRoutingStrategy::BuildInfrastructure (VanetScenario &scenario)
+{
+  NodeContainer rsus = scenario.GetRsus ();
+  NS_ABORT_MSG_IF (rsus.GetN () == 0, "Routing=sdn needs at least one RSU");
+  NS_ABORT_MSG_IF (m_topology != "tree" && m_topology != "fattree", "Unknown BackhaulTopology: " << m_topology);
+
+  m_backhaul.SetFanout (m_switchFanout);
+  m_backhaul.SetFatTree (m_topology == "fattree");
+  m_backhaul.SetLink (m_backhaulRate, m_backhaulDelay);
+  m_backhaul.SetServerCount (m_serverCount);
+  m_backhaul.Build (rsus, scenario.GetRsuPositions (), scenario.GetInternet ());
+
+  // Chia switch cho NumControllers controller theo vùng: switch thuộc shard
+  // của RSU đầu tiên trong cây con, nên mỗi shard là một dải RSU liền số (một
+  // vùng của lưới / đoạn đường) và switch gốc thuộc shard 0.
+  NodeContainer switches = m_backhaul.GetSwitches ();
+  uint32_t shards = m_controllerCount;
+  NS_ABORT_MSG_IF (shards > 100, "NumControllers must be at most 100");
+  std::vector<uint32_t> shardSwitches (shards, 0);
+  for (uint32_t i = 0; i < switches.GetN (); i++)
+    {
+      uint32_t shard = uint64_t (m_backhaul.GetFirstRsu (i)) * shards / rsus.GetN ();
+      m_switchShard.push_back (shard);
+      shardSwitches[shard]++;
+    }
+  for (uint32_t k = 0; k < shards; k++)
+    {
+      NS_ABORT_MSG_IF (shardSwitches[k] == 0, "NumControllers=" << shards << " leaves shard " << k
+                       << " without switches, use a smaller SwitchFanout or fewer controllers");
+    }
+
+  // Controller 0 phía trên switch gốc, các controller khác phía trên switch
+  // đầu tiên của vùng mình
+  m_controllers.Create (shards);
+  scenario.GetInternet ().Install (m_controllers);
+  MobilityHelper mobilityStatic;
+  mobilityStatic.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  Ptr<ListPositionAllocator> staticPositions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t k = 0; k < shards; k++)
+    {
+      uint32_t first = std::find (m_switchShard.begin (), m_switchShard.end (), k) - m_switchShard.begin ();
+      const Vector &position = m_backhaul.GetSwitchPosition (k == 0 ? m_backhaul.GetRoot () : first);
+      staticPositions->Add (Vector (position.x, position.y + 50.0, 0.0));
+    }
+  mobilityStatic.SetPositionAllocator (staticPositions);
+  mobilityStatic.Install (m_controllers);
+
+  // Kênh OpenFlow riêng cho mỗi shard (mạng CSMA chung của controller và các
+  // switch trong shard, 10.(100+k).0.0/16) với băng thông và trễ cấu hình được
+  std::vector<Ptr<OFSwitch13InternalHelper> > helpers;
+  for (uint32_t k = 0; k < shards; k++)
+    {
+      Ptr<VanetSdnController> controller = CreateObject<VanetSdnController> ();
+      Ptr<OFSwitch13InternalHelper> helper = CreateObject<OFSwitch13InternalHelper> ();
+      helper->SetAttribute ("ChannelDataRate", DataRateValue (m_controlRate));
+      helper->InstallController (m_controllers.Get (k), controller);
+      m_shards.push_back (controller);
+      helpers.push_back (helper);
+    }
+
+  // Switch được cài sau khi đủ cổng; luật theo datapath id của từng switch
+  for (uint32_t i = 0; i < switches.GetN (); i++)
+    {
+      Ptr<VanetSdnController> controller = m_shards[m_switchShard[i]];
+      Ptr<OFSwitch13InternalHelper> helper = helpers[m_switchShard[i]];
+      Ptr<OFSwitch13Device> device = helper->InstallSwitch (switches.Get (i), m_backhaul.GetSwitchPorts (i));
+      m_dpIds.push_back (device->GetDatapathId ());
+      m_dpShard[m_dpIds[i]] = m_switchShard[i];
+      if (m_backhaul.GetUplinkPort (i) != 0)
+        {
+          controller->SetUplink (m_dpIds[i], m_backhaul.GetUplinkPort (i));
+        }
+    }
+  for (const BackhaulTopology::Route &route : m_backhaul.GetRoutes ())
+    {
+      m_shards[m_switchShard[route.sw]]->AddRoute (m_dpIds[route.sw], route.network, route.mask, route.port);
+    }
+  for (uint32_t k = 0; k < shards; k++)
+    {
+      std::string network = "10." + std::to_string (100 + k) + ".0.0";
+      OFSwitch13Helper::SetAddressBase (Ipv4Address (network.c_str ()), Ipv4Mask ("255.255.0.0"));
+      helpers[k]->CreateOpenFlowChannels ();
+
+      // Trễ đặt trên chính các kênh CSMA của shard, không đổi giá trị mặc định
+      // của mọi CsmaChannel tạo sau đó
+      Ptr<Node> controllerNode = m_controllers.Get (k);
+      for (uint32_t d = 0; d < controllerNode->GetNDevices (); d++)
+        {
+          Ptr<CsmaNetDevice> device = DynamicCast<CsmaNetDevice> (controllerNode->GetDevice (d));
+          if (device)
+            {
+              device->GetChannel ()->SetAttribute ("Delay", TimeValue (m_controlDelay));
+            }
+        }
+    }
+
+  NodeContainer servers = m_backhaul.GetServers ();
+  for (uint32_t i = 0; i < servers.GetN (); i++)
+    {
+      scenario.AddServer (servers.Get (i), m_backhaul.GetServerAddress (i));
+      m_handoverMonitor.AddServer (servers.Get (i), m_backhaul.GetServerAddress (i));
+    }
+  if (m_wirelessRouting == "olsr")
+    {
+      for (uint32_t i = 0; i < rsus.GetN (); i++)
+        {
+          AdvertiseNetwork (rsus.Get (i), BackhaulTopology::GetServerBlock (), BackhaulTopology::GetBlockMask ());
+        }
+    }
+
+  NodeContainer vehicles = scenario.GetVehicles ();
+  m_vehiclePorts.assign (vehicles.GetN (), std::vector<VanetSdnController::PortMap> (shards));
+  for (uint32_t i = 0; i < vehicles.GetN (); i++)
+    {
+      m_vehicleAddresses.push_back (scenario.GetVehicleAddress (i));
+      m_handoverMonitor.AddVehicle (vehicles.Get (i), scenario.GetVehicleAddress (i));
+    }
+  m_tracker.Setup (&scenario.GetFleet (), scenario.GetRsuPositions ());
+  m_tracker.SetInterval (m_trackInterval);
+  m_tracker.SetHorizon (m_predictionHorizon);
+  m_tracker.SetHysteresis (m_hysteresis);
+  m_tracker.SetHandoverCallback (MakeCallback (&SdnRoutingStrategy::HandleHandover, this));
+  m_tracker.SetPredictionCallback (MakeCallback (&SdnRoutingStrategy::HandlePrediction, this));
+  m_tracker.Start ();
+
+  if (m_wirelessRouting == "olsr")
+    {
+      m_olsrOverhead.Install ();
+      return;
+    }
+  std::vector<Ipv4Address> addresses = m_vehicleAddresses;
+  for (uint32_t i = 0; i < rsus.GetN (); i++)
+    {
+      addresses.push_back (scenario.GetRsuAddress (i));
+    }
+  double range = m_linkRange > 0 ? m_linkRange : GetRadioRange (vehicles.Get (0));
+  m_central.Setup (&scenario.GetFleet (), vehicles, rsus, scenario.GetRsuPositions (), addresses);
+  m_central.SetServerNetwork (BackhaulTopology::GetServerBlock (), BackhaulTopology::GetBlockMask ());
+  m_central.SetRange (range);
+  m_central.SetInterval (m_topologyInterval);
+  m_central.SetPathMetric (m_pathMetric == "load" ? CentralRouteController::LOAD : CentralRouteController::HOPS);
+  // Bản tin đi từ controller qua các tầng switch xuống RSU
+  Time backhaul = NanoSeconds (m_backhaulDelay.GetNanoSeconds () * (m_backhaul.GetDepth () + 1));
+  m_central.SetControlDelay (backhaul, m_controlHopDelay);
+  m_central.SetVerify (m_verifyRoutes);
+  m_central.Start ();
+}
+
+double
+SdnRoutingStrategy::GetRadioRange (Ptr<Node> node)
+{
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice (i));
+      if (device)
+        {
+          return GetDecodableRange (device);
+        }
+    }
+  NS_FATAL_ERROR ("Node " << node->GetId () << " has no Wi-Fi device");
+  return 0.0;
+}
+
+void
+SdnRoutingStrategy::HandleHandover (uint32_t vehicle, int32_t from, int32_t to)
+{
+  if (from >= 0)
+    {
+      m_handoverMonitor.NotifyHandover (vehicle, Simulator::Now ());
+    }
+  UpdateHostRoute (vehicle, to, -1);
+}
+
+void
+SdnRoutingStrategy::HandlePrediction (uint32_t vehicle, int32_t current, int32_t next)
+{
+  // Cài sẵn đường qua RSU kế tiếp, gói xuống đi kép cho tới khi handover;
+  // hai đường tách nhau ở switch chung thấp nhất
+  UpdateHostRoute (vehicle, current, next);
+}
+
+void
+SdnRoutingStrategy::UpdateHostRoute (uint32_t vehicle, int32_t rsu, int32_t other)
+{
+  // Shard của RSU phục vụ nhận sự kiện và cài luật ngay; phần luật trên switch
+  // của shard khác (switch gốc, nhánh tới RSU kế tiếp) được đồng bộ sau SyncDelay
+  VanetSdnController::PortMap ports = GetPorts (rsu, other);
+  std::vector<VanetSdnController::PortMap> shares (m_shards.size ());
+  for (const auto &entry : ports)
+    {
+      shares[m_dpShard[entry.first]].insert (entry);
+    }
+  uint32_t owner = m_switchShard[m_backhaul.GetEdgeSwitch (rsu)];
+  std::vector<VanetSdnController::PortMap> &previous = m_vehiclePorts[vehicle];
+  Ipv4Address host = m_vehicleAddresses[vehicle];
+  Time now = Simulator::Now ();
+  for (uint32_t k = 0; k < m_shards.size (); k++)
+    {
+      if (shares[k] == previous[k])
+        {
+          continue;
+        }
+      if (k == owner)
+        {
+          m_shards[k]->SetHostRoute (host, shares[k], now);
+        }
+      else
+        {
+          m_syncMessages++;
+          Simulator::Schedule (m_syncDelay, &VanetSdnController::SyncHostRoute, m_shards[k], host, shares[k], now);
+        }
+    }
+  previous = shares;
+}
+
+VanetSdnController::PortMap
+SdnRoutingStrategy::GetPorts (int32_t rsu, int32_t other) const
+{
+  VanetSdnController::PortMap ports;
+  for (int32_t r : { rsu, other })
+    {
+      if (r < 0)
+        {
+          continue;
+        }
+      for (const auto &hop : m_backhaul.GetPath (r))
+        {
+          std::vector<uint32_t> &out = ports[m_dpIds[hop.first]];
+          if (std::find (out.begin (), out.end (), hop.second) == out.end ())
+            {
+              out.push_back (hop.second);
+            }
+        }
+    }
+  return ports;
+}
+
+void
+SdnRoutingStrategy::AdvertiseNetwork (Ptr<Node> node, Ipv4Address network, Ipv4Mask mask)
+{
+  Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (node->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  for (uint32_t i = 0; i < list->GetNRoutingProtocols (); i++)
+    {
+      int16_t priority;
+      Ptr<olsr::RoutingProtocol> olsr = DynamicCast<olsr::RoutingProtocol> (list->GetRoutingProtocol (i, priority));
+      if (olsr)
+        {
+          olsr->AddHostNetworkAssociation (network, mask);
+          return;
+        }
+    }
+  NS_FATAL_ERROR ("Node " << node->GetId () << " has no OLSR");
+}
+
+void
+SdnRoutingStrategy::Report (std::ostream &os)
+{
+  if (!m_shards.empty ())
+    {
+      os << "Backhaul: " << m_backhaul.GetSwitchCount () << " switch (" << m_backhaul.GetDepth () << " tầng, "
+         << m_topology << "), " << m_backhaul.GetServers ().GetN () << " server, "
+         << m_backhaul.GetRoutes ().size () << " luật tiền tố, dựng hạ tầng " << m_setupSeconds << " s"
+         << std::endl;
+      std::vector<double> latencies;
+      for (uint32_t k = 0; k < m_shards.size (); k++)
+        {
+          os << "[shard " << k << ", " << m_shards[k]->GetSwitchCount () << " switch] ";
+          m_shards[k]->Report (os);
+          const std::vector<double> &shard = m_shards[k]->GetSetupLatencies ();
+          latencies.insert (latencies.end (), shard.begin (), shard.end ());
+        }
+      os << "Control plane: " << m_shards.size () << " controller, " << m_syncMessages
+         << " bản tin đồng bộ giữa shard, thiết lập luật theo xe: ";
+      VanetSdnController::PrintLatencies (os, latencies);
+      os << std::endl;
+      os << "Handover: " << m_tracker.GetHandoverCount () << " lần, " << m_tracker.GetPredictedHandoverCount ()
+         << " lần đã dự đoán trước RSU đích" << std::endl;
+      m_handoverMonitor.Report (os);
+    }
+  if (m_wirelessRouting == "central")
+    {
+      m_central.Report (os);
+    }
+  else
+    {
+      m_olsrOverhead.Report (os);
+    }
+}
+
+#endif /* SDNROUTING_H */
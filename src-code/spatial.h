@@ -0,0 +1,347 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+
+// Chỉ mục không gian dạng lưới đều (theo mặt phẳng x, y) cho xe và RSU.
+// Mỗi ô giữ danh sách id nằm trong ô; truy vấn bán kính chỉ duyệt các ô
+// giao với hình tròn, truy vấn k gần nhất mở rộng dần theo vòng ô.
+// Ô được lưu trong bảng băm nên vùng mô phỏng không bị giới hạn kích thước.
+class SpatialGrid
+{
+public:
+  SpatialGrid (double cellSize = 30.0);
+
+  void SetCellSize (double cellSize);
+  double GetCellSize (void) const;
+  void Clear (void);
+
+  // id nên liên tục từ 0 (ví dụ chỉ số node trong NodeContainer)
+  void Insert (uint32_t id, const Vector &pos);
+  // Chỉ chuyển ô khi vị trí mới rơi vào ô khác
+  void Update (uint32_t id, const Vector &pos);
+  void Remove (uint32_t id);
+  bool Contains (uint32_t id) const;
+  const Vector &GetPosition (uint32_t id) const;
+  uint32_t GetN (void) const;
+
+  // Các id cách tâm không quá radius, sắp xếp tăng dần theo id
+  void QueryRadius (const Vector &center, double radius, std::vector<uint32_t> &result) const;
+  // k id gần tâm nhất, sắp xếp theo khoảng cách (bằng nhau thì theo id)
+  void QueryNearest (const Vector &center, uint32_t k, std::vector<uint32_t> &result) const;
+  // id gần nhất, -1 nếu lưới rỗng
+  int32_t Nearest (const Vector &center) const;
+
+private:
+  typedef int64_t CellKey;
+
+  struct Item
+  {
+    Vector   pos;
+    CellKey  cell;
+    uint32_t slot;     // vị trí trong danh sách của ô
+    bool     present;
+  };
+
+  int32_t CellCoord (double v) const;
+  CellKey Key (int32_t cx, int32_t cy) const;
+  void AddToCell (uint32_t id, CellKey cell);
+  void RemoveFromCell (uint32_t id);
+  static double Distance2 (const Vector &a, const Vector &b);
+
+  double                                           m_cellSize;
+  std::unordered_map<CellKey, std::vector<uint32_t> > m_cells;
+  std::vector<Item>                                m_items;
+  uint32_t                                         m_count;
+  int32_t                                          m_minCx;   // biên các ô đã dùng, để dừng tìm kiếm vòng
+  int32_t                                          m_maxCx;
+  int32_t                                          m_minCy;
+  int32_t                                          m_maxCy;
+};
+
+SpatialGrid::SpatialGrid (double cellSize)
+  : m_cellSize (cellSize),
+    m_count (0),
+    m_minCx (0),
+    m_maxCx (-1),
+    m_minCy (0),
+    m_maxCy (-1)
+{
+}
+
+void
+SpatialGrid::SetCellSize (double cellSize)
+{
+  NS_ABORT_MSG_IF (cellSize <= 0, "Cell size must be positive");
+  m_cellSize = cellSize;
+
+  // Dựng lại lưới với kích thước ô mới
+  std::vector<Item> items;
+  items.swap (m_items);
+  Clear ();
+  for (uint32_t id = 0; id < items.size (); id++)
+    {
+      if (items[id].present)
+        {
+          Insert (id, items[id].pos);
+        }
+    }
+}
+
+double
+SpatialGrid::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+void
+SpatialGrid::Clear (void)
+{
+  m_cells.clear ();
+  m_items.clear ();
+  m_count = 0;
+  m_minCx = 0;
+  m_maxCx = -1;
+  m_minCy = 0;
+  m_maxCy = -1;
+}
+
+void
+SpatialGrid::Insert (uint32_t id, const Vector &pos)
+{
+  if (id >= m_items.size ())
+    {
+      Item empty;
+      empty.cell = 0;
+      empty.slot = 0;
+      empty.present = false;
+      m_items.resize (id + 1, empty);
+    }
+  if (m_items[id].present)
+    {
+      Update (id, pos);
+      return;
+    }
+
+  int32_t cx = CellCoord (pos.x);
+  int32_t cy = CellCoord (pos.y);
+  if (m_maxCx < m_minCx)
+    {
+      m_minCx = m_maxCx = cx;
+      m_minCy = m_maxCy = cy;
+    }
+  m_minCx = std::min (m_minCx, cx);
+  m_maxCx = std::max (m_maxCx, cx);
+  m_minCy = std::min (m_minCy, cy);
+  m_maxCy = std::max (m_maxCy, cy);
+
+  m_items[id].pos = pos;
+  m_items[id].present = true;
+  AddToCell (id, Key (cx, cy));
+  m_count++;
+}
+
+void
+SpatialGrid::Update (uint32_t id, const Vector &pos)
+{
+  if (id >= m_items.size () || !m_items[id].present)
+    {
+      Insert (id, pos);
+      return;
+    }
+
+  int32_t cx = CellCoord (pos.x);
+  int32_t cy = CellCoord (pos.y);
+  CellKey cell = Key (cx, cy);
+  m_items[id].pos = pos;
+  if (cell != m_items[id].cell)
+    {
+      RemoveFromCell (id);
+      AddToCell (id, cell);
+      m_minCx = std::min (m_minCx, cx);
+      m_maxCx = std::max (m_maxCx, cx);
+      m_minCy = std::min (m_minCy, cy);
+      m_maxCy = std::max (m_maxCy, cy);
+    }
+}
+
+void
+SpatialGrid::Remove (uint32_t id)
+{
+  if (!Contains (id))
+    {
+      return;
+    }
+  RemoveFromCell (id);
+  m_items[id].present = false;
+  m_count--;
+}
+
+bool
+SpatialGrid::Contains (uint32_t id) const
+{
+  return id < m_items.size () && m_items[id].present;
+}
+
+const Vector &
+SpatialGrid::GetPosition (uint32_t id) const
+{
+  return m_items[id].pos;
+}
+
+uint32_t
+SpatialGrid::GetN (void) const
+{
+  return m_count;
+}
+
+void
+SpatialGrid::QueryRadius (const Vector &center, double radius, std::vector<uint32_t> &result) const
+{
+  result.clear ();
+  double r2 = radius * radius;
+  int32_t x0 = CellCoord (center.x - radius);
+  int32_t x1 = CellCoord (center.x + radius);
+  int32_t y0 = CellCoord (center.y - radius);
+  int32_t y1 = CellCoord (center.y + radius);
+  for (int32_t cx = std::max (x0, m_minCx); cx <= std::min (x1, m_maxCx); cx++)
+    {
+      for (int32_t cy = std::max (y0, m_minCy); cy <= std::min (y1, m_maxCy); cy++)
+        {
+          std::unordered_map<CellKey, std::vector<uint32_t> >::const_iterator it = m_cells.find (Key (cx, cy));
+          if (it == m_cells.end ())
+            {
+              continue;
+            }
+          for (uint32_t id : it->second)
+            {
+              if (Distance2 (m_items[id].pos, center) <= r2)
+                {
+                  result.push_back (id);
+                }
+            }
+        }
+    }
+  std::sort (result.begin (), result.end ());
+}
+
+void
+SpatialGrid::QueryNearest (const Vector &center, uint32_t k, std::vector<uint32_t> &result) const
+{
+  result.clear ();
+  if (k == 0 || m_count == 0)
+    {
+      return;
+    }
+  k = std::min (k, m_count);
+
+  int32_t ccx = CellCoord (center.x);
+  int32_t ccy = CellCoord (center.y);
+  // Số vòng tối đa để phủ hết các ô đã dùng
+  int32_t maxRing = std::max (std::max (std::abs (ccx - m_minCx), std::abs (ccx - m_maxCx)),
+                              std::max (std::abs (ccy - m_minCy), std::abs (ccy - m_maxCy)));
+
+  std::vector<std::pair<double, uint32_t> > candidates;
+  for (int32_t ring = 0; ring <= maxRing; ring++)
+    {
+      for (int32_t cx = ccx - ring; cx <= ccx + ring; cx++)
+        {
+          // Trên vòng ring chỉ duyệt các ô ở biên
+          int32_t step = (cx == ccx - ring || cx == ccx + ring) ? 1 : 2 * ring;
+          for (int32_t cy = ccy - ring; cy <= ccy + ring; cy += std::max (step, 1))
+            {
+              std::unordered_map<CellKey, std::vector<uint32_t> >::const_iterator it = m_cells.find (Key (cx, cy));
+              if (it == m_cells.end ())
+                {
+                  continue;
+                }
+              for (uint32_t id : it->second)
+                {
+                  candidates.push_back (std::make_pair (Distance2 (m_items[id].pos, center), id));
+                }
+            }
+        }
+
+      // Mọi điểm ở vòng sau cách tâm ít nhất ring * cellSize
+      if (candidates.size () >= k)
+        {
+          std::nth_element (candidates.begin (), candidates.begin () + (k - 1), candidates.end ());
+          double bound = ring * m_cellSize;
+          if (candidates[k - 1].first <= bound * bound)
+            {
+              break;
+            }
+        }
+    }
+
+  std::sort (candidates.begin (), candidates.end ());
+  for (uint32_t i = 0; i < k && i < candidates.size (); i++)
+    {
+      result.push_back (candidates[i].second);
+    }
+}
+
+int32_t
+SpatialGrid::Nearest (const Vector &center) const
+{
+  std::vector<uint32_t> result;
+  QueryNearest (center, 1, result);
+  return result.empty () ? -1 : static_cast<int32_t> (result[0]);
+}
+
+int32_t
+SpatialGrid::CellCoord (double v) const
+{
+  return static_cast<int32_t> (std::floor (v / m_cellSize));
+}
+
+SpatialGrid::CellKey
+SpatialGrid::Key (int32_t cx, int32_t cy) const
+{
+  return static_cast<CellKey> ((static_cast<uint64_t> (static_cast<uint32_t> (cx)) << 32)
+                               | static_cast<uint32_t> (cy));
+}
+
+void
+SpatialGrid::AddToCell (uint32_t id, CellKey cell)
+{
+  std::vector<uint32_t> &ids = m_cells[cell];
+  m_items[id].cell = cell;
+  m_items[id].slot = ids.size ();
+  ids.push_back (id);
+}
+
+void
+SpatialGrid::RemoveFromCell (uint32_t id)
+{
+  // Đổi chỗ với phần tử cuối để xóa trong O(1)
+  std::vector<uint32_t> &ids = m_cells[m_items[id].cell];
+  uint32_t slot = m_items[id].slot;
+  ids[slot] = ids.back ();
+  m_items[ids[slot]].slot = slot;
+  ids.pop_back ();
+  if (ids.empty ())
+    {
+      m_cells.erase (m_items[id].cell);
+    }
+}
+
+double
+SpatialGrid::Distance2 (const Vector &a, const Vector &b)
+{
+  double dx = a.x - b.x;
+  double dy = a.y - b.y;
+  return dx * dx + dy * dy;
+}
+
+#endif /* SPATIAL_H */